@@ -0,0 +1,12 @@
+QT += core serialport
+TARGET = cw_trainer_bench
+TEMPLATE = app
+CONFIG += console release
+CONFIG -= app_bundle
+
+include(TrainerEngine.pri)
+
+SOURCES += src/bench/main.cpp \
+    src/SerialManager.cpp
+
+HEADERS += src/SerialManager.h
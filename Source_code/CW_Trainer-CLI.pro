@@ -0,0 +1,9 @@
+QT += core
+TARGET = cw_trainer_cli
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+include(TrainerEngine.pri)
+
+SOURCES += src/cli/main.cpp
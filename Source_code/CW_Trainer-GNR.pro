@@ -2,18 +2,23 @@ QT += core gui widgets serialport multimedia
 TARGET = CW_Trainer-GNR
 TEMPLATE = app
 
+include(TrainerEngine.pri)
+
 SOURCES += src/main.cpp \
     src/MainWindow.cpp \
     src/CheatSheetWindow.cpp \
+    src/MorseQueue.cpp \
+    src/RxLogModel.cpp \
+    src/RxLogView.cpp \
     src/SerialManager.cpp \
     src/SoundGenerator.cpp \
-    src/StatisticsTracker.cpp \
     src/StatisticsWindow.cpp
 
 HEADERS += src/MainWindow.h \
     src/CheatSheetWindow.h \
-    src/MorseUtils.h \
+    src/MorseQueue.h \
+    src/RxLogModel.h \
+    src/RxLogView.h \
     src/SerialManager.h \
     src/SoundGenerator.h \
-    src/StatisticsTracker.h \
     src/StatisticsWindow.h
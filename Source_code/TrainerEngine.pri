@@ -0,0 +1,49 @@
+# Trainer engine: drill generation, scoring, statistics and Morse synthesis.
+# No widgets and no audio output (SoundGenerator lives in the GUI project);
+# shared by the GUI (CW_Trainer-GNR.pro), the command-line front end
+# (CW_Trainer-CLI.pro) and the benchmarks (CW_Trainer-Bench.pro).
+QT += core
+INCLUDEPATH += $$PWD/src
+
+SOURCES += $$PWD/src/AdaptiveSampler.cpp \
+    $$PWD/src/AliasTable.cpp \
+    $$PWD/src/AttemptJournal.cpp \
+    $$PWD/src/ConfusionMatrix.cpp \
+    $$PWD/src/EditAligner.cpp \
+    $$PWD/src/KochEngine.cpp \
+    $$PWD/src/LatencyStats.cpp \
+    $$PWD/src/LegacyCsvLoader.cpp \
+    $$PWD/src/MarkovTextGenerator.cpp \
+    $$PWD/src/MorseSynth.cpp \
+    $$PWD/src/QsoGenerator.cpp \
+    $$PWD/src/ReviewScheduler.cpp \
+    $$PWD/src/SessionStore.cpp \
+    $$PWD/src/StatisticsTracker.cpp \
+    $$PWD/src/StatsIndex.cpp \
+    $$PWD/src/StreamAligner.cpp \
+    $$PWD/src/TrainerEngine.cpp \
+    $$PWD/src/TrendRollups.cpp \
+    $$PWD/src/WordCorpus.cpp
+
+HEADERS += $$PWD/src/AdaptiveSampler.h \
+    $$PWD/src/AliasTable.h \
+    $$PWD/src/AttemptJournal.h \
+    $$PWD/src/CharIndex.h \
+    $$PWD/src/ConfusionMatrix.h \
+    $$PWD/src/EditAligner.h \
+    $$PWD/src/FlatHashMap.h \
+    $$PWD/src/KochEngine.h \
+    $$PWD/src/LatencyStats.h \
+    $$PWD/src/LegacyCsvLoader.h \
+    $$PWD/src/MarkovTextGenerator.h \
+    $$PWD/src/MorseSynth.h \
+    $$PWD/src/MorseUtils.h \
+    $$PWD/src/QsoGenerator.h \
+    $$PWD/src/ReviewScheduler.h \
+    $$PWD/src/SessionStore.h \
+    $$PWD/src/StatisticsTracker.h \
+    $$PWD/src/StatsIndex.h \
+    $$PWD/src/StreamAligner.h \
+    $$PWD/src/TrainerEngine.h \
+    $$PWD/src/TrendRollups.h \
+    $$PWD/src/WordCorpus.h
@@ -0,0 +1,70 @@
+#include "AdaptiveSampler.h"
+#include "StatisticsTracker.h"
+
+namespace {
+// Floor so well-known characters still show up now and then
+const double kBaseWeight = 0.05;
+// Mean latency that counts as neutral; slower characters weigh more
+const double kReferenceLatencyMs = 600.0;
+}
+
+AdaptiveSampler::AdaptiveSampler(const StatisticsTracker *tracker) : m_tracker(tracker)
+{
+}
+
+void AdaptiveSampler::setTracker(const StatisticsTracker *tracker)
+{
+    m_tracker = tracker;
+    m_dirty = true;
+}
+
+void AdaptiveSampler::setAlphabet(const QString &chars)
+{
+    QString unique;
+    for (QChar c : chars) {
+        if (!c.isSpace() && !unique.contains(c)) unique.append(c);
+    }
+    if (unique == m_alphabet) return;
+    m_alphabet = unique;
+    m_dirty = true;
+}
+
+double AdaptiveSampler::weight(QChar c) const
+{
+    if (!m_tracker) return 1.0;
+    const CharStats &stats = m_tracker->getCharStats()[CharIndex::id(c)];
+
+    // Laplace-smoothed error rate: an unseen character starts at 0.5
+    double errorRate = (stats.wrong + 1.0) / (stats.given + 2.0);
+
+    // Slow recognition is the next thing to train once errors are rare
+    double latencyFactor = 1.0;
+    if (stats.latency.count > 0) latencyFactor = qBound(0.5, stats.latency.meanMs() / kReferenceLatencyMs, 3.0);
+
+    return kBaseWeight + errorRate * latencyFactor;
+}
+
+void AdaptiveSampler::rebuild()
+{
+    QVector<double> weights(m_alphabet.size());
+    for (int i = 0; i < m_alphabet.size(); ++i) weights[i] = weight(m_alphabet[i]);
+    m_table.build(weights);
+    m_dirty = false;
+}
+
+QChar AdaptiveSampler::next(QRandomGenerator *rng)
+{
+    if (m_alphabet.isEmpty()) return QChar();
+    if (m_dirty) rebuild();
+    return m_alphabet[m_table.sample(*rng)];
+}
+
+QString AdaptiveSampler::group(int length, QRandomGenerator *rng)
+{
+    QString res;
+    if (m_alphabet.isEmpty()) return res;
+    if (m_dirty) rebuild();
+    res.reserve(length);
+    for (int i = 0; i < length; ++i) res.append(m_alphabet[m_table.sample(*rng)]);
+    return res;
+}
@@ -0,0 +1,47 @@
+#ifndef ADAPTIVESAMPLER_H
+#define ADAPTIVESAMPLER_H
+
+// Include standard Qt classes for strings and random numbers
+#include <QString>
+#include <QRandomGenerator>
+#include "AliasTable.h"
+
+class StatisticsTracker;
+
+// Draws drill characters in proportion to how badly they are currently copied.
+// Each character of the alphabet is weighted by its smoothed error rate in the
+// tracker's session stats, scaled by its mean recognition latency, so weak and
+// slow characters come up more often while unseen ones still get explored.
+// The weights live in an alias table that is rebuilt lazily after the stats
+// change (one O(alphabet) pass per attempt), so every draw is O(1).
+class AdaptiveSampler
+{
+public:
+    explicit AdaptiveSampler(const StatisticsTracker *tracker = nullptr);
+
+    void setTracker(const StatisticsTracker *tracker);
+
+    // Characters to draw from (duplicates are ignored)
+    void setAlphabet(const QString &chars);
+    const QString &alphabet() const { return m_alphabet; }
+
+    // The tracker's stats changed (call after every recorded attempt)
+    void invalidate() { m_dirty = true; }
+
+    // Draws one character / a group of characters
+    QChar next(QRandomGenerator *rng = QRandomGenerator::global());
+    QString group(int length, QRandomGenerator *rng = QRandomGenerator::global());
+
+    // Current sampling weight of a character (unnormalized)
+    double weight(QChar c) const;
+
+private:
+    void rebuild();
+
+    const StatisticsTracker *m_tracker;
+    QString m_alphabet;
+    AliasTable m_table;
+    bool m_dirty = true;
+};
+
+#endif // ADAPTIVESAMPLER_H
@@ -0,0 +1,37 @@
+#include "AliasTable.h"
+
+void AliasTable::build(const QVector<double> &weights)
+{
+    const int n = weights.size();
+    m_prob = QVector<double>(n, 1.0);
+    m_alias = QVector<int>(n);
+    for (int i = 0; i < n; ++i) m_alias[i] = i;
+    if (n == 0) return;
+
+    double sum = 0;
+    for (double w : weights) sum += qMax(0.0, w);
+    if (sum <= 0) return; // Uniform
+
+    // Scale so the average column holds exactly 1
+    QVector<double> scaled(n);
+    QVector<int> small, large;
+    small.reserve(n);
+    large.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        scaled[i] = qMax(0.0, weights[i]) * n / sum;
+        (scaled[i] < 1.0 ? small : large).append(i);
+    }
+
+    // Fill every under-full column with the remainder of an over-full one
+    while (!small.isEmpty() && !large.isEmpty()) {
+        int s = small.takeLast();
+        int l = large.takeLast();
+        m_prob[s] = scaled[s];
+        m_alias[s] = l;
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        (scaled[l] < 1.0 ? small : large).append(l);
+    }
+    // Whatever is left is full up to rounding error
+    for (int i : large) m_prob[i] = 1.0;
+    for (int i : small) m_prob[i] = 1.0;
+}
@@ -0,0 +1,31 @@
+#ifndef ALIASTABLE_H
+#define ALIASTABLE_H
+
+// Include standard Qt classes for containers and random numbers
+#include <QVector>
+#include <QRandomGenerator>
+
+// Walker/Vose alias table: draws index i with probability weight[i] / sum(weights)
+// in O(1) (one uniform index plus one coin flip), after an O(n) build.
+class AliasTable
+{
+public:
+    // Builds the table; non-positive or empty weights give a uniform table
+    void build(const QVector<double> &weights);
+
+    // Draws an index in [0, size())
+    int sample(QRandomGenerator &rng) const
+    {
+        int i = int(rng.bounded(quint32(m_prob.size())));
+        return rng.generateDouble() < m_prob[i] ? i : m_alias[i];
+    }
+
+    int size() const { return m_prob.size(); }
+    bool isEmpty() const { return m_prob.isEmpty(); }
+
+private:
+    QVector<double> m_prob; // Probability of keeping column i
+    QVector<int> m_alias;   // Index drawn instead when column i is not kept
+};
+
+#endif // ALIASTABLE_H
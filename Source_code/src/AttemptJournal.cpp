@@ -0,0 +1,308 @@
+#include "AttemptJournal.h"
+#include <QtEndian>
+#include <QDebug>
+#include <array>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+// File header identifying the journal format
+const char kMagic[4] = {'C', 'W', 'J', '1'};
+
+// Sync policy: fsync after this many records or this much time, whichever first
+const int kSyncBatch = 32;
+const qint64 kSyncIntervalMs = 2000;
+
+// Record framing: type (1) + payload length (2) before, CRC32 (4) after
+const int kRecordHeader = 3;
+const int kRecordTrailer = 4;
+
+// Standard CRC-32 (IEEE 802.3), table driven
+quint32 crc32(const char *data, int len)
+{
+    // Built once; the initialization of a function-local static is thread-safe
+    static const std::array<quint32, 256> table = [] {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    quint32 crc = 0xFFFFFFFFu;
+    for (int i = 0; i < len; ++i) {
+        crc = table[(crc ^ quint8(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Little-endian append helpers
+template <typename T>
+void put(QByteArray &buf, T value)
+{
+    T le = qToLittleEndian(value);
+    buf.append(reinterpret_cast<const char *>(&le), sizeof(T));
+}
+
+// Strings are capped so an attempt record always fits the 16-bit payload length;
+// the cut is moved back to a character boundary so the UTF-8 stays valid
+void putString(QByteArray &buf, const QString &s)
+{
+    QByteArray utf8 = s.toUtf8();
+    if (utf8.size() > 0x7FF0) {
+        int cut = 0x7FF0;
+        while (cut > 0 && (quint8(utf8[cut]) & 0xC0) == 0x80) --cut;
+        utf8.truncate(cut);
+    }
+    put<quint16>(buf, quint16(utf8.size()));
+    buf.append(utf8);
+}
+
+// Bounds-checked little-endian reader over a payload
+struct Reader {
+    const char *p;
+    const char *end;
+    bool ok = true;
+
+    template <typename T>
+    T get() {
+        if (end - p < qint64(sizeof(T))) { ok = false; return T(); }
+        T v = qFromLittleEndian<T>(p);
+        p += sizeof(T);
+        return v;
+    }
+
+    QString getString() {
+        quint16 len = get<quint16>();
+        if (!ok || end - p < len) { ok = false; return QString(); }
+        QString s = QString::fromUtf8(p, len);
+        p += len;
+        return s;
+    }
+};
+
+// Flush Qt's buffer and force the OS to write the file to disk
+void syncToDisk(QFile &file)
+{
+    file.flush();
+    int fd = file.handle();
+    if (fd < 0) return;
+#ifdef Q_OS_WIN
+    _commit(fd);
+#else
+    ::fsync(fd);
+#endif
+}
+}
+
+AttemptJournal::AttemptJournal()
+{
+}
+
+AttemptJournal::~AttemptJournal()
+{
+    close();
+}
+
+bool AttemptJournal::open(const QString &path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Could not open attempt journal" << path << m_file.errorString();
+        return false;
+    }
+    // New file: write the header first
+    if (m_file.size() == 0) {
+        m_file.write(kMagic, sizeof(kMagic));
+        syncToDisk(m_file);
+    }
+    m_unsynced = 0;
+    m_sinceSync.start();
+    return true;
+}
+
+void AttemptJournal::close()
+{
+    if (m_file.isOpen()) {
+        sync();
+        m_file.close();
+    }
+}
+
+bool AttemptJournal::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+void AttemptJournal::beginSession(const QDateTime &start)
+{
+    JournalRecord r;
+    r.type = JournalRecordType::SessionBegin;
+    r.timestampMs = start.toMSecsSinceEpoch();
+    writeRecord(r);
+    sync();
+}
+
+void AttemptJournal::appendAttempt(const QString &target, const QString &user, int wpm,
+                                   const QVector<JournalLatency> &latencies)
+{
+    JournalRecord r;
+    r.type = JournalRecordType::Attempt;
+    r.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    r.wpm = quint16(qBound(0, wpm, 0xFFFF));
+    r.target = target;
+    r.user = user;
+    r.latencies = latencies;
+    writeRecord(r);
+}
+
+void AttemptJournal::endSession(const QDateTime &start)
+{
+    JournalRecord r;
+    r.type = JournalRecordType::SessionEnd;
+    r.timestampMs = start.toMSecsSinceEpoch();
+    writeRecord(r);
+    sync();
+}
+
+void AttemptJournal::sync()
+{
+    if (!m_file.isOpen()) return;
+    syncToDisk(m_file);
+    m_unsynced = 0;
+    m_sinceSync.restart();
+}
+
+// Write one record. The flush hands it to the OS right away; the fsync is batched.
+void AttemptJournal::writeRecord(const JournalRecord &record)
+{
+    if (!m_file.isOpen()) return;
+    m_file.write(encode(record));
+    m_file.flush();
+    m_unsynced++;
+    if (m_unsynced >= kSyncBatch || m_sinceSync.elapsed() >= kSyncIntervalMs) {
+        sync();
+    }
+}
+
+QByteArray AttemptJournal::encode(const JournalRecord &record)
+{
+    QByteArray payload;
+    put<qint64>(payload, record.timestampMs);
+    put<quint16>(payload, record.wpm);
+    if (record.type == JournalRecordType::Attempt) {
+        putString(payload, record.target);
+        putString(payload, record.user);
+        // Latencies follow the strings, so older readers skip them; as many
+        // as fit the payload length are kept
+        const int room = (0xFFFF - payload.size() - int(sizeof(quint16))) / 3;
+        const int count = qBound(0, record.latencies.size(), room);
+        put<quint16>(payload, quint16(count));
+        for (int i = 0; i < count; ++i) {
+            put<quint8>(payload, record.latencies[i].charId);
+            put<quint16>(payload, record.latencies[i].ms);
+        }
+    }
+
+    QByteArray buf;
+    buf.reserve(kRecordHeader + payload.size() + kRecordTrailer);
+    put<quint8>(buf, quint8(record.type));
+    put<quint16>(buf, quint16(payload.size()));
+    buf.append(payload);
+    put<quint32>(buf, crc32(buf.constData(), buf.size()));
+    return buf;
+}
+
+QVector<JournalRecord> AttemptJournal::read(const QString &path, qint64 *validBytes, qint64 fromOffset)
+{
+    QVector<JournalRecord> records;
+    if (validBytes) *validBytes = 0;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return records;
+    if (file.read(sizeof(kMagic)) != QByteArray(kMagic, sizeof(kMagic))) return records;
+
+    // Only the part from fromOffset on is read into memory
+    const qint64 start = qMax(qint64(sizeof(kMagic)), fromOffset);
+    if (start > file.size() || !file.seek(start)) return records;
+    QByteArray data = file.readAll();
+    file.close();
+
+    // Positions below are relative to start
+    const char *base = data.constData();
+    qint64 pos = 0;
+    if (validBytes) *validBytes = start;
+    qint64 size = data.size();
+    while (size - pos >= kRecordHeader + kRecordTrailer) {
+        quint8 type = quint8(base[pos]);
+        quint16 len = qFromLittleEndian<quint16>(base + pos + 1);
+        qint64 total = kRecordHeader + len + kRecordTrailer;
+        // Torn record at the tail: stop here
+        if (size - pos < total) break;
+
+        quint32 stored = qFromLittleEndian<quint32>(base + pos + kRecordHeader + len);
+        if (stored != crc32(base + pos, kRecordHeader + len)) {
+            qWarning() << "Attempt journal" << path << "corrupt at offset" << start + pos << "- ignoring the rest";
+            break;
+        }
+
+        Reader rd{base + pos + kRecordHeader, base + pos + kRecordHeader + len};
+        JournalRecord r;
+        r.type = JournalRecordType(type);
+        r.timestampMs = rd.get<qint64>();
+        r.wpm = rd.get<quint16>();
+        if (r.type == JournalRecordType::Attempt) {
+            r.target = rd.getString();
+            r.user = rd.getString();
+            // Optional latency list (absent in records of older versions)
+            if (rd.ok && rd.p < rd.end) {
+                const quint16 count = rd.get<quint16>();
+                for (int i = 0; i < count && rd.ok; ++i) {
+                    JournalLatency l;
+                    l.charId = rd.get<quint8>();
+                    l.ms = rd.get<quint16>();
+                    if (rd.ok) r.latencies.append(l);
+                }
+            }
+        }
+        if (!rd.ok) break;
+
+        records.append(r);
+        pos += total;
+        if (validBytes) *validBytes = start + pos;
+    }
+    return records;
+}
+
+bool AttemptJournal::append(const QString &path, const QVector<JournalRecord> &records)
+{
+    // Records after a torn or corrupt tail would never be read back, so the
+    // file is cut back to its last intact record first
+    qint64 validBytes = 0;
+    if (QFile::exists(path)) read(path, &validBytes);
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) return false;
+    if (file.size() >= qint64(sizeof(kMagic)) && validBytes == 0) {
+        qWarning() << "Not appending to" << path << "- not an attempt journal";
+        return false;
+    }
+    if (file.size() > validBytes) file.resize(validBytes);
+    file.seek(validBytes);
+    if (validBytes == 0) file.write(kMagic, sizeof(kMagic));
+
+    QByteArray buf;
+    for (const JournalRecord &r : records) buf.append(encode(r));
+    bool ok = file.write(buf) == buf.size();
+    // A partial write is undone, so a retry does not leave a torn record behind
+    if (!ok && validBytes > 0) file.resize(validBytes);
+    syncToDisk(file);
+    file.close();
+    return ok;
+}
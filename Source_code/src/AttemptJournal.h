@@ -0,0 +1,82 @@
+#ifndef ATTEMPTJOURNAL_H
+#define ATTEMPTJOURNAL_H
+
+// Include standard Qt classes for file access, strings and timing
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QDateTime>
+#include <QElapsedTimer>
+
+// Kind of record stored in the journal
+enum class JournalRecordType : quint8 {
+    SessionBegin = 1, // A training session started (timestamp = session start)
+    Attempt = 2,      // One answer was checked
+    SessionEnd = 3    // The session was written to the session store (timestamp = session start)
+};
+
+// Recognition latency of one copied character of an attempt
+struct JournalLatency {
+    quint8 charId = 0; // CharIndex id
+    quint16 ms = 0;    // Milliseconds (LatencyStats::MaxMs + 1 for "too slow")
+};
+
+// Decoded journal record
+struct JournalRecord {
+    JournalRecordType type = JournalRecordType::Attempt;
+    qint64 timestampMs = 0; // Milliseconds since epoch
+    quint16 wpm = 0;        // Speed at the time of the attempt
+    QString target;         // Normalized target (Attempt only)
+    QString user;           // Normalized answer (Attempt only)
+    QVector<JournalLatency> latencies; // Attempt only; empty in records of older versions
+};
+
+// Append-only write-ahead journal of training attempts.
+// Every record is length-prefixed and protected by a CRC32, so a torn write at
+// the end of the file (crash, power loss) is detected and dropped on replay.
+// Records are flushed to the OS on every append (survives an application
+// crash) and fsync'ed in batches (bounds what a power loss can take).
+class AttemptJournal
+{
+public:
+    AttemptJournal();
+    ~AttemptJournal();
+
+    // Opens (or creates) the journal for appending
+    bool open(const QString &path = defaultFile());
+    // Syncs and closes the journal
+    void close();
+    bool isOpen() const;
+
+    // Record writers
+    void beginSession(const QDateTime &start);
+    void appendAttempt(const QString &target, const QString &user, int wpm,
+                       const QVector<JournalLatency> &latencies = {});
+    void endSession(const QDateTime &start);
+
+    // Forces pending records to stable storage
+    void sync();
+
+    // Reads every valid record of a journal/archive file, starting at the
+    // record boundary fromOffset (a validBytes of an earlier read).
+    // validBytes receives the offset just past the last intact record.
+    static QVector<JournalRecord> read(const QString &path, qint64 *validBytes = nullptr, qint64 fromOffset = 0);
+
+    // Appends records to a journal-format file (used to compact into the archive).
+    // A torn tail left by an earlier crash is cut off first.
+    static bool append(const QString &path, const QVector<JournalRecord> &records);
+
+    // Default file names (next to statistics.csv)
+    static QString defaultFile() { return QStringLiteral("attempts.journal"); }
+    static QString archiveFile() { return QStringLiteral("attempt_history.dat"); }
+
+private:
+    void writeRecord(const JournalRecord &record);
+    static QByteArray encode(const JournalRecord &record);
+
+    QFile m_file;
+    int m_unsynced = 0;          // Records written since the last fsync
+    QElapsedTimer m_sinceSync;   // Time since the last fsync
+};
+
+#endif // ATTEMPTJOURNAL_H
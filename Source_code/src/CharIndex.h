@@ -0,0 +1,61 @@
+#ifndef CHARINDEX_H
+#define CHARINDEX_H
+
+// Include the QChar and QString classes for character handling
+#include <QChar>
+#include <QString>
+
+// Maps characters to a compact, dense id so statistics can live in flat arrays
+// instead of maps. Ids 0..TrackedCount-1 follow the column order used in
+// statistics.csv (A-Z, 0-9, ? . , / = +).
+class CharIndex {
+public:
+    static constexpr int TrackedCount = 42; // Characters persisted in the statistics files
+    static constexpr int Count = 45;        // Known characters (tracked + remaining Morse punctuation)
+    static constexpr int Other = Count;     // Any character outside the alphabet
+    static constexpr int Gap = Count + 1;   // "No character": omission or insertion in confusion records
+    static constexpr int Size = Count + 2;  // Total number of ids
+
+    // The alphabet in id order
+    static const char *alphabet() {
+        return "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789?.,/=+-()";
+    }
+
+    // Returns the id of a character (case-insensitive), or Other
+    static int id(QChar c) {
+        // Lookup table for ASCII, built once on first use
+        static const Table table;
+        ushort u = c.unicode();
+        return u < 128 ? table.ids[u] : Other;
+    }
+
+    // Returns the character for an id (null for Other/Gap)
+    static QChar charAt(int id) {
+        if (id < 0 || id >= Count) return QChar();
+        return QChar(alphabet()[id]);
+    }
+
+    // Short display label for an id, matching the CSV column names
+    static QString label(int id) {
+        if (id == Gap) return QString(QChar(0x2205)); // Empty set sign
+        if (id == Other) return QStringLiteral("*");
+        QChar c = charAt(id);
+        return c == ',' ? QStringLiteral("COMMA") : QString(c);
+    }
+
+private:
+    struct Table {
+        unsigned char ids[128];
+        Table() {
+            for (int i = 0; i < 128; ++i) ids[i] = Other;
+            const char *a = alphabet();
+            for (int i = 0; i < Count; ++i) {
+                ids[int(a[i])] = i;
+                // Lowercase letters share the uppercase id
+                if (a[i] >= 'A' && a[i] <= 'Z') ids[int(a[i] - 'A' + 'a')] = i;
+            }
+        }
+    };
+};
+
+#endif // CHARINDEX_H
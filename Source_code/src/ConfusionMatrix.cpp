@@ -0,0 +1,76 @@
+#include "ConfusionMatrix.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <cstring>
+
+namespace {
+// File header: magic "CWCM", format version and matrix dimension
+const quint32 kMagic = 0x4D435743;
+const quint32 kVersion = 1;
+}
+
+ConfusionMatrix::ConfusionMatrix()
+{
+    clear();
+}
+
+quint32 ConfusionMatrix::rowTotal(int targetId) const
+{
+    quint32 sum = 0;
+    const quint32 *row = m_cells + targetId * Dim;
+    for (int j = 0; j < Dim; ++j) sum += row[j];
+    return sum;
+}
+
+void ConfusionMatrix::add(const ConfusionMatrix &other)
+{
+    for (int i = 0; i < Dim * Dim; ++i) m_cells[i] += other.m_cells[i];
+}
+
+void ConfusionMatrix::clear()
+{
+    std::memset(m_cells, 0, sizeof(m_cells));
+}
+
+bool ConfusionMatrix::isEmpty() const
+{
+    for (int i = 0; i < Dim * Dim; ++i) {
+        if (m_cells[i]) return false;
+    }
+    return true;
+}
+
+// Load a matrix saved by save(). Leaves the matrix empty on any mismatch.
+bool ConfusionMatrix::load(const QString &path)
+{
+    clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setByteOrder(QDataStream::LittleEndian);
+    quint32 magic = 0, version = 0, dim = 0;
+    in >> magic >> version >> dim;
+    if (magic != kMagic || version != kVersion || dim != quint32(Dim)) return false;
+
+    for (int i = 0; i < Dim * Dim; ++i) in >> m_cells[i];
+    if (in.status() != QDataStream::Ok) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+// Save via QSaveFile so a crash mid-write never leaves a truncated file behind
+bool ConfusionMatrix::save(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << kMagic << kVersion << quint32(Dim);
+    for (int i = 0; i < Dim * Dim; ++i) out << m_cells[i];
+    return file.commit();
+}
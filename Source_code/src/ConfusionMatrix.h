@@ -0,0 +1,50 @@
+#ifndef CONFUSIONMATRIX_H
+#define CONFUSIONMATRIX_H
+
+// Include standard Qt classes for strings and fixed-width integers
+#include <QString>
+#include <QtGlobal>
+#include "CharIndex.h"
+
+// Dense confusion matrix: rows are target characters, columns are typed characters.
+// Stored as one flat row-major array of CharIndex::Size x CharIndex::Size counters.
+//  - Diagonal cells count correct copies
+//  - Column CharIndex::Gap counts omissions (target char dropped)
+//  - Row CharIndex::Gap counts insertions (extra char typed)
+class ConfusionMatrix
+{
+public:
+    static constexpr int Dim = CharIndex::Size;
+
+    ConfusionMatrix();
+
+    // Increments the cell for (target id, typed id)
+    void record(int targetId, int typedId) { m_cells[targetId * Dim + typedId]++; }
+
+    // Reads a single cell
+    quint32 at(int targetId, int typedId) const { return m_cells[targetId * Dim + typedId]; }
+
+    // Sum of a row (everything recorded for one target character)
+    quint32 rowTotal(int targetId) const;
+
+    // Adds every cell of another matrix to this one
+    void add(const ConfusionMatrix &other);
+
+    // Resets all cells to zero
+    void clear();
+
+    // True if no cell has been recorded
+    bool isEmpty() const;
+
+    // Binary persistence (little-endian counters behind a small header)
+    bool load(const QString &path);
+    bool save(const QString &path) const;
+
+    // Default file holding the matrix accumulated across all sessions
+    static QString historyFile() { return QStringLiteral("confusion_history.dat"); }
+
+private:
+    quint32 m_cells[Dim * Dim];
+};
+
+#endif // CONFUSIONMATRIX_H
@@ -0,0 +1,122 @@
+#include "EditAligner.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+// Align target vs user, widening the band until the result is exact
+Alignment EditAligner::align(const QString &target, const QString &user)
+{
+    int n = target.length();
+    int m = user.length();
+
+    // The distance is at least the length difference, so start just above it
+    int k = qMax(qAbs(n - m), 1);
+    int limit = qMax(n, m);
+
+    Alignment result;
+    while (true) {
+        result = Alignment();
+        if (alignBanded(target, user, k, result) || k >= limit) {
+            break;
+        }
+        // Distance did not fit in the band: double it and retry
+        k = qMin(k * 2, limit);
+    }
+    return result;
+}
+
+// Banded DP. Row i covers target[0..i), column j covers user[0..j).
+// Only cells with |i - j| <= k are stored, at offset (j - i + k).
+bool EditAligner::alignBanded(const QString &target, const QString &user, int k, Alignment &out)
+{
+    const int n = target.length();
+    const int m = user.length();
+    const int width = 2 * k + 1;
+    const int INF = std::numeric_limits<int>::max() / 2;
+
+    // Two keys per cell: the edit cost, and among paths of that cost the most
+    // matches. Without the second key a tie would go to whichever move is
+    // tried first, and a swapped pair ("AB" typed "BA") would score as two
+    // substitutions instead of keeping one of its characters.
+    std::vector<int> dp((n + 1) * width, INF);
+    std::vector<int> hits((n + 1) * width, 0);
+    auto index = [&](int i, int j) { return i * width + (j - i + k); };
+    auto cell = [&](int i, int j) -> int & { return dp[index(i, j)]; };
+    auto inBand = [&](int i, int j) { return j >= 0 && j <= m && qAbs(j - i) <= k; };
+    // Lower cost wins, then more matches
+    auto better = [](int cost, int matches, int bestCost, int bestMatches) {
+        return cost < bestCost || (cost == bestCost && matches > bestMatches);
+    };
+
+    // Fill the band row by row
+    for (int i = 0; i <= n; ++i) {
+        int jLo = qMax(0, i - k);
+        int jHi = qMin(m, i + k);
+        for (int j = jLo; j <= jHi; ++j) {
+            if (i == 0) { cell(i, j) = j; continue; }
+            if (j == 0) { cell(i, j) = i; continue; }
+
+            int best = INF;
+            int bestHits = 0;
+            // Diagonal: match or substitution
+            if (inBand(i - 1, j - 1)) {
+                bool same = (target[i - 1] == user[j - 1]);
+                best = cell(i - 1, j - 1) + (same ? 0 : 1);
+                bestHits = hits[index(i - 1, j - 1)] + (same ? 1 : 0);
+            }
+            // Up: target character omitted
+            if (inBand(i - 1, j) && better(cell(i - 1, j) + 1, hits[index(i - 1, j)], best, bestHits)) {
+                best = cell(i - 1, j) + 1;
+                bestHits = hits[index(i - 1, j)];
+            }
+            // Left: extra typed character
+            if (inBand(i, j - 1) && better(cell(i, j - 1) + 1, hits[index(i, j - 1)], best, bestHits)) {
+                best = cell(i, j - 1) + 1;
+                bestHits = hits[index(i, j - 1)];
+            }
+            cell(i, j) = best;
+            hits[index(i, j)] = bestHits;
+        }
+    }
+
+    if (!inBand(n, m)) return false;
+    int dist = cell(n, m);
+    if (dist > k) return false;
+
+    // Backtrack from the end along a path that realizes both keys. Every
+    // minimum-cost path stays within dist <= k diagonals, so the band holds
+    // the best of them. Among equal paths the diagonal is preferred, so a
+    // wrong character is reported as a substitution rather than delete + insert.
+    out.distance = dist;
+    out.steps.reserve(qMax(n, m) + dist);
+    int i = n, j = m;
+    while (i > 0 || j > 0) {
+        int cur = cell(i, j);
+        int curHits = hits[index(i, j)];
+        if (i > 0 && j > 0 && inBand(i - 1, j - 1)) {
+            bool same = (target[i - 1] == user[j - 1]);
+            if (cur == cell(i - 1, j - 1) + (same ? 0 : 1) && curHits == hits[index(i - 1, j - 1)] + (same ? 1 : 0)) {
+                if (same) {
+                    out.steps.append({EditOp::Match, target[i - 1], user[j - 1], i - 1, j - 1});
+                    out.matches++;
+                } else {
+                    out.steps.append({EditOp::Substitute, target[i - 1], user[j - 1], i - 1, j - 1});
+                    out.substitutions++;
+                }
+                i--; j--;
+                continue;
+            }
+        }
+        if (i > 0 && inBand(i - 1, j) && cur == cell(i - 1, j) + 1 && curHits == hits[index(i - 1, j)]) {
+            out.steps.append({EditOp::Delete, target[i - 1], QChar(), i - 1, -1});
+            out.deletions++;
+            i--;
+        } else {
+            out.steps.append({EditOp::Insert, QChar(), user[j - 1], -1, j - 1});
+            out.insertions++;
+            j--;
+        }
+    }
+    std::reverse(out.steps.begin(), out.steps.end());
+    return true;
+}
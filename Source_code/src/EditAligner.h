@@ -0,0 +1,52 @@
+#ifndef EDITALIGNER_H
+#define EDITALIGNER_H
+
+// Include standard Qt classes for strings and containers
+#include <QString>
+#include <QVector>
+
+// Kind of step produced when aligning the target against the user's answer
+enum class EditOp : quint8 {
+    Match,      // Target character copied correctly
+    Substitute, // Target character copied as a different character (e.g. H -> S)
+    Delete,     // Target character omitted by the user
+    Insert      // Extra character typed that is not in the target
+};
+
+// One step of the alignment
+struct AlignedPair {
+    EditOp op;
+    QChar target;    // Target character (null for Insert)
+    QChar typed;     // Typed character (null for Delete)
+    int targetIndex; // Position in target (-1 for Insert)
+    int typedIndex;  // Position in user string (-1 for Delete)
+};
+
+// Result of aligning a target string against a user string
+struct Alignment {
+    QVector<AlignedPair> steps; // Steps in reading order
+    int distance = 0;           // Levenshtein distance
+    int matches = 0;            // Number of Match steps
+    int substitutions = 0;      // Number of Substitute steps
+    int deletions = 0;          // Number of Delete steps (omissions)
+    int insertions = 0;         // Number of Insert steps
+};
+
+// Computes a minimum edit-distance alignment between two strings; of the
+// alignments with that distance, the one with the most matches.
+// Uses Ukkonen's banded dynamic programming: only cells within k diagonals
+// of the main diagonal are evaluated, and k is doubled until the distance
+// found fits inside the band. Near-correct answers therefore cost
+// O((n + m) * k) instead of O(n * m).
+class EditAligner
+{
+public:
+    static Alignment align(const QString &target, const QString &user);
+
+private:
+    // Attempts an alignment restricted to band k.
+    // Returns false if the distance exceeds k (result would not be exact).
+    static bool alignBanded(const QString &target, const QString &user, int k, Alignment &out);
+};
+
+#endif // EDITALIGNER_H
@@ -0,0 +1,99 @@
+#ifndef FLATHASHMAP_H
+#define FLATHASHMAP_H
+
+// Include standard Qt classes for strings, hashing and containers
+#include <QString>
+#include <QHash>
+#include <QVector>
+
+// Open-addressing hash map from QString to V using linear probing.
+// All slots live in a single contiguous array (no per-node allocation), the
+// capacity is a power of two and the table grows before it is 70% full.
+template <typename V>
+class FlatHashMap
+{
+public:
+    explicit FlatHashMap(int initialCapacity = 64) { reset(initialCapacity); }
+
+    // Returns the value for key, inserting a default-constructed one if missing
+    V &operator[](const QString &key) {
+        if ((m_size + 1) * 10 > m_slots.size() * 7) grow();
+        size_t h = qHash(key);
+        int idx = probe(key, h);
+        Slot &slot = m_slots[idx];
+        if (!slot.used) {
+            slot.used = true;
+            slot.hash = h;
+            slot.key = key;
+            slot.value = V();
+            m_size++;
+        }
+        return slot.value;
+    }
+
+    // Returns a pointer to the value for key, or nullptr if missing (never inserts)
+    const V *find(const QString &key) const {
+        const Slot &slot = m_slots[probe(key, qHash(key))];
+        return slot.used ? &slot.value : nullptr;
+    }
+
+    // Number of stored entries
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    // Removes all entries and shrinks back to the initial capacity
+    void clear() { reset(64); }
+
+    // Calls f(key, value) for every entry, in slot order
+    template <typename F>
+    void forEach(F f) const {
+        for (const Slot &slot : m_slots) {
+            if (slot.used) f(slot.key, slot.value);
+        }
+    }
+
+private:
+    struct Slot {
+        QString key;
+        V value = V();
+        size_t hash = 0;
+        bool used = false;
+    };
+
+    void reset(int capacity) {
+        int cap = 8;
+        while (cap < capacity) cap *= 2;
+        m_slots = QVector<Slot>(cap);
+        m_size = 0;
+    }
+
+    // Index of the slot holding key, or of the empty slot where it would go
+    int probe(const QString &key, size_t h) const {
+        int mask = m_slots.size() - 1;
+        int idx = int(h) & mask;
+        while (m_slots[idx].used) {
+            if (m_slots[idx].hash == h && m_slots[idx].key == key) return idx;
+            idx = (idx + 1) & mask;
+        }
+        return idx;
+    }
+
+    // Doubles the capacity and re-inserts every entry
+    void grow() {
+        QVector<Slot> old;
+        old.swap(m_slots);
+        m_slots = QVector<Slot>(old.size() * 2);
+        int mask = m_slots.size() - 1;
+        for (Slot &slot : old) {
+            if (!slot.used) continue;
+            int idx = int(slot.hash) & mask;
+            while (m_slots[idx].used) idx = (idx + 1) & mask;
+            m_slots[idx] = std::move(slot);
+        }
+    }
+
+    QVector<Slot> m_slots;
+    int m_size = 0;
+};
+
+#endif // FLATHASHMAP_H
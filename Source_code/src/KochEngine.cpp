@@ -0,0 +1,119 @@
+#include "KochEngine.h"
+#include "EditAligner.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+
+namespace {
+// File header: magic "CWKO" and format version
+const quint32 kMagic = 0x4F4B5743;
+const quint32 kVersion = 1;
+// Share of draws that go to the newest character
+const double kNewestShare = 0.3;
+}
+
+KochEngine::KochEngine()
+{
+    reset();
+}
+
+void KochEngine::reset()
+{
+    m_unlocked = FirstLessonChars;
+    m_window.clear();
+    m_window.reserve(WindowSize);
+    m_windowHead = 0;
+    m_windowCorrect = 0;
+}
+
+double KochEngine::windowAccuracy() const
+{
+    return m_window.isEmpty() ? 0.0 : double(m_windowCorrect) / m_window.size();
+}
+
+QString KochEngine::generateGroup(int length, QRandomGenerator *rng) const
+{
+    const QString chars = activeChars();
+    QString res;
+    res.reserve(length);
+    for (int i = 0; i < length; ++i) {
+        if (rng->generateDouble() < kNewestShare) res.append(newestChar());
+        else res.append(chars[int(rng->bounded(quint32(chars.size())))]);
+    }
+    return res;
+}
+
+bool KochEngine::recordAttempt(const QString &target, const QString &answer)
+{
+    // Score each target character through the same alignment the statistics use
+    Alignment alignment = EditAligner::align(target.trimmed().toUpper(), answer.trimmed().toUpper());
+    for (const AlignedPair &step : alignment.steps) {
+        if (step.op == EditOp::Insert || step.target == ' ') continue;
+        bool correct = step.op == EditOp::Match;
+
+        if (m_window.size() < WindowSize) {
+            m_window.append(correct);
+        } else {
+            m_windowCorrect -= m_window[m_windowHead] ? 1 : 0;
+            m_window[m_windowHead] = correct;
+            m_windowHead = (m_windowHead + 1) % WindowSize;
+        }
+        if (correct) m_windowCorrect++;
+    }
+
+    // Advance once a full window meets the threshold
+    if (isComplete() || m_window.size() < WindowSize || windowAccuracy() < Threshold) return false;
+    int unlocked = m_unlocked + 1;
+    reset();
+    m_unlocked = unlocked;
+    return true;
+}
+
+// Load the learner state; starts at lesson 1 if missing or invalid
+bool KochEngine::load(const QString &path)
+{
+    reset();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setByteOrder(QDataStream::LittleEndian);
+    quint32 magic = 0, version = 0;
+    qint32 unlocked = 0, head = 0, count = 0;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion) return false;
+    in >> unlocked >> head >> count;
+    if (in.status() != QDataStream::Ok || unlocked < FirstLessonChars || unlocked > order().size() ||
+        count < 0 || count > WindowSize || head < 0 || head >= WindowSize) {
+        return false;
+    }
+
+    QVector<bool> window(count);
+    int correct = 0;
+    for (int i = 0; i < count; ++i) {
+        quint8 bit = 0;
+        in >> bit;
+        window[i] = bit != 0;
+        correct += window[i] ? 1 : 0;
+    }
+    if (in.status() != QDataStream::Ok) return false;
+
+    m_unlocked = unlocked;
+    m_window = window;
+    m_windowHead = head;
+    m_windowCorrect = correct;
+    return true;
+}
+
+// Save via QSaveFile so a crash mid-write never loses the previous state
+bool KochEngine::save(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << kMagic << kVersion << qint32(m_unlocked) << qint32(m_windowHead) << qint32(m_window.size());
+    for (bool bit : m_window) out << quint8(bit ? 1 : 0);
+    return file.commit();
+}
@@ -0,0 +1,62 @@
+#ifndef KOCHENGINE_H
+#define KOCHENGINE_H
+
+// Include standard Qt classes for strings and random numbers
+#include <QString>
+#include <QVector>
+#include <QRandomGenerator>
+
+// Koch-method progression.
+// Lessons start with the first two characters of the Koch order (K, M) and add
+// one character at a time. Every copied target character is scored into a
+// rolling window for the current lesson; once the window is full and its
+// accuracy reaches the threshold, the next character is unlocked and a fresh
+// window starts. The learner state is saved after every attempt so progress
+// carries over between sessions, whatever drill (PC audio or device) is used.
+class KochEngine
+{
+public:
+    static constexpr int WindowSize = 100;        // Characters scored per lesson window
+    static constexpr double Threshold = 0.90;     // Accuracy needed to advance
+    static constexpr int FirstLessonChars = 2;    // K and M
+
+    KochEngine();
+
+    // Full Koch character order
+    static QString order() { return QStringLiteral("KMRSUAPTLOWI.NJEF0YV,G5/Q9ZH38B?427C1D6X"); }
+
+    // Characters unlocked so far, in Koch order
+    QString activeChars() const { return order().left(m_unlocked); }
+    // Most recently unlocked character
+    QChar newestChar() const { return order()[m_unlocked - 1]; }
+    int lesson() const { return m_unlocked - FirstLessonChars + 1; }
+    bool isComplete() const { return m_unlocked >= order().size(); }
+
+    // Rolling window of the current lesson
+    int windowCount() const { return m_window.size(); }
+    double windowAccuracy() const;
+
+    // Random group over the active characters; the newest character is
+    // drawn more often, as usual for Koch drills
+    QString generateGroup(int length, QRandomGenerator *rng = QRandomGenerator::global()) const;
+
+    // Scores every target character of an attempt. Returns true if this
+    // attempt unlocked a new character.
+    bool recordAttempt(const QString &target, const QString &answer);
+
+    // Starts over at lesson 1
+    void reset();
+
+    // Persistence (small binary file next to the statistics)
+    bool load(const QString &path = stateFile());
+    bool save(const QString &path = stateFile()) const;
+    static QString stateFile() { return QStringLiteral("koch_state.dat"); }
+
+private:
+    int m_unlocked = FirstLessonChars; // Number of characters of order() in use
+    QVector<bool> m_window;            // Ring buffer of per-character results
+    int m_windowHead = 0;              // Next slot to overwrite once full
+    int m_windowCorrect = 0;           // Correct results currently in the window
+};
+
+#endif // KOCHENGINE_H
@@ -0,0 +1,63 @@
+#include "LatencyStats.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+
+namespace {
+// File header: magic "CWLT", format version, table size and bin count
+const quint32 kMagic = 0x544C5743;
+const quint32 kVersion = 1;
+}
+
+void LatencyTable::add(const LatencyTable &other)
+{
+    for (int id = 0; id < CharIndex::Size; ++id) m_stats[id].merge(other.m_stats[id]);
+}
+
+void LatencyTable::clear()
+{
+    m_stats.fill(LatencyStats());
+}
+
+// Load a table saved by save(). Leaves the table empty on any mismatch.
+bool LatencyTable::load(const QString &path)
+{
+    clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setByteOrder(QDataStream::LittleEndian);
+    quint32 magic = 0, version = 0, size = 0, bins = 0;
+    in >> magic >> version >> size >> bins;
+    if (magic != kMagic || version != kVersion || size != quint32(CharIndex::Size) ||
+        bins != quint32(LatencyStats::BinCount)) {
+        return false;
+    }
+
+    for (LatencyStats &s : m_stats) {
+        in >> s.count >> s.totalMs;
+        for (qint32 &b : s.bins) in >> b;
+    }
+    if (in.status() != QDataStream::Ok) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+// Save via QSaveFile so a crash mid-write never leaves a truncated file behind
+bool LatencyTable::save(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << kMagic << kVersion << quint32(CharIndex::Size) << quint32(LatencyStats::BinCount);
+    for (const LatencyStats &s : m_stats) {
+        out << s.count << s.totalMs;
+        for (qint32 b : s.bins) out << b;
+    }
+    return file.commit();
+}
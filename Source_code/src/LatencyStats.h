@@ -0,0 +1,88 @@
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+// Include standard Qt classes for strings and fixed-width integers
+#include <QString>
+#include <QtGlobal>
+#include <array>
+#include "CharIndex.h"
+
+// Recognition latency distribution of one character: how long after the end
+// of its audio (RX) or after the previous keyed character (TX) it was typed.
+// A fixed histogram plus count and sum, so sessions merge by addition.
+struct LatencyStats {
+    static constexpr int BinCount = 12;
+    // Upper bin edges in ms; the last bin is open-ended
+    static constexpr std::array<int, BinCount - 1> Edges = {100, 200, 300, 400, 500, 650, 800, 1000, 1300, 1700, 2500};
+    // Longer gaps are distraction, not recognition, and are not recorded
+    static constexpr int MaxMs = 10000;
+
+    qint32 count = 0;
+    qint64 totalMs = 0;
+    std::array<qint32, BinCount> bins{};
+
+    void add(int ms)
+    {
+        if (ms < 0 || ms > MaxMs) return;
+        count++;
+        totalMs += ms;
+        bins[binFor(ms)]++;
+    }
+
+    void merge(const LatencyStats &other)
+    {
+        count += other.count;
+        totalMs += other.totalMs;
+        for (int b = 0; b < BinCount; ++b) bins[b] += other.bins[b];
+    }
+
+    double meanMs() const { return count > 0 ? double(totalMs) / count : 0; }
+
+    // Upper edge of the bin holding the p-quantile (p in 0..1); MaxMs for the open bin
+    int percentileMs(double p) const
+    {
+        if (count == 0) return 0;
+        qint64 rank = qint64(p * count);
+        qint64 seen = 0;
+        for (int b = 0; b < BinCount - 1; ++b) {
+            seen += bins[b];
+            if (seen > rank) return Edges[b];
+        }
+        return MaxMs;
+    }
+
+    static int binFor(int ms)
+    {
+        int b = 0;
+        while (b < BinCount - 1 && ms >= Edges[b]) ++b;
+        return b;
+    }
+};
+
+// Per-character latency distributions, indexed by CharIndex id, with the same
+// persistence scheme as ConfusionMatrix (latency_history.dat accumulates all
+// sessions).
+class LatencyTable
+{
+public:
+    LatencyStats &operator[](int id) { return m_stats[id]; }
+    const LatencyStats &at(int id) const { return m_stats[id]; }
+
+    // Adds every distribution of another table to this one
+    void add(const LatencyTable &other);
+
+    // Resets all distributions
+    void clear();
+
+    // Binary persistence (little-endian counters behind a small header)
+    bool load(const QString &path);
+    bool save(const QString &path) const;
+
+    // Default file holding the distributions accumulated across all sessions
+    static QString historyFile() { return QStringLiteral("latency_history.dat"); }
+
+private:
+    std::array<LatencyStats, CharIndex::Size> m_stats;
+};
+
+#endif // LATENCYSTATS_H
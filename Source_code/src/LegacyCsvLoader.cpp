@@ -0,0 +1,282 @@
+#include "LegacyCsvLoader.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace {
+// Below this body size a single thread is faster than spawning workers
+const qint64 kMinParallelBytes = 256 * 1024;
+
+// A field inside the mapped file
+struct Span {
+    const char *p;
+    int len;
+};
+
+// Parses an optionally signed decimal integer; stops at the first non-digit
+qint32 parseInt(Span s)
+{
+    const char *p = s.p;
+    const char *end = s.p + s.len;
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    qint32 v = 0;
+    while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+    return neg ? -v : v;
+}
+
+// Parses a plain decimal number such as "87.5" (the only form the CSV uses)
+float parseFloat(Span s)
+{
+    const char *p = s.p;
+    const char *end = s.p + s.len;
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    double v = 0;
+    while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+    if (p < end && *p == '.') {
+        ++p;
+        double scale = 0.1;
+        while (p < end && *p >= '0' && *p <= '9') {
+            v += (*p++ - '0') * scale;
+            scale *= 0.1;
+        }
+    }
+    return float(neg ? -v : v);
+}
+
+// Reads n digits at p; -1 if any is not a digit
+int fixedDigits(const char *p, int n)
+{
+    int v = 0;
+    for (int i = 0; i < n; ++i) {
+        if (p[i] < '0' || p[i] > '9') return -1;
+        v = v * 10 + (p[i] - '0');
+    }
+    return v;
+}
+
+// "yyyy-MM-dd" + "HH:mm:ss" without going through QDateTime::fromString
+QDateTime parseDateTime(Span date, Span time)
+{
+    if (date.len < 10 || time.len < 8) return QDateTime();
+    int y = fixedDigits(date.p, 4), mo = fixedDigits(date.p + 5, 2), d = fixedDigits(date.p + 8, 2);
+    int h = fixedDigits(time.p, 2), mi = fixedDigits(time.p + 3, 2), sec = fixedDigits(time.p + 6, 2);
+    if (y < 0 || mo < 0 || d < 0 || h < 0 || mi < 0 || sec < 0) return QDateTime();
+    return QDateTime(QDate(y, mo, d), QTime(h, mi, sec));
+}
+
+// Parses the rows in [begin, end); both ends are on line boundaries
+void parseChunk(const char *begin, const char *end, const QVector<int> &columns, LegacyCsvLoader::Result &out)
+{
+    QVector<Span> fields;
+    fields.reserve(columns.size() + 1);
+
+    const char *p = begin;
+    while (p < end) {
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+        const char *lineEnd = eol;
+        if (lineEnd > p && lineEnd[-1] == '\r') --lineEnd; // Written in text mode on Windows
+
+        if (lineEnd > p) {
+            // Split on commas
+            fields.clear();
+            const char *f = p;
+            for (const char *c = p; c < lineEnd; ++c) {
+                if (*c == ',') {
+                    fields.append({f, int(c - f)});
+                    f = c + 1;
+                }
+            }
+            fields.append({f, int(lineEnd - f)});
+
+            if (fields.size() < columns.size()) {
+                out.skippedLines++; // Skip malformed lines
+            } else {
+                SessionRecord r;
+                r.start = parseDateTime(fields[0], fields[1]);
+                for (int i = 2; i < columns.size(); ++i) {
+                    const Span &s = fields[i];
+                    switch (columns[i]) {
+                    case -1:
+                    case SessionStore::ColStart: break;
+                    case SessionStore::ColAccuracy: r.accuracy = parseFloat(s); break;
+                    case SessionStore::ColMode: r.mode = QString::fromUtf8(s.p, s.len); break;
+                    case SessionStore::ColItems: r.items = QString::fromUtf8(s.p, s.len); break;
+                    case SessionStore::ColDuration: r.duration = parseInt(s); break;
+                    case SessionStore::ColAttempts: r.attempts = parseInt(s); break;
+                    case SessionStore::ColCorrect: r.correct = parseInt(s); break;
+                    case SessionStore::ColWrong: r.wrong = parseInt(s); break;
+                    case SessionStore::ColWpm: r.wpm = parseInt(s); break;
+                    case SessionStore::ColTone: r.tone = parseInt(s); break;
+                    default: {
+                        if (columns[i] >= SessionStore::ColLatencyBase) {
+                            // Present in CSV files exported by newer versions
+                            int k = columns[i] - SessionStore::ColLatencyBase;
+                            CharLatency &cl = r.latency[k / 2];
+                            if (k % 2 == 0) cl.count = parseInt(s); else cl.totalMs = parseInt(s);
+                            break;
+                        }
+                        int k = columns[i] - SessionStore::ColCharBase;
+                        CharCounts &cc = r.chars[k / 3];
+                        qint32 v = parseInt(s);
+                        if (k % 3 == 0) cc.total = v; else if (k % 3 == 1) cc.ok = v; else cc.err = v;
+                        break;
+                    }
+                    }
+                }
+                // Per-thread partial aggregates
+                for (int id = 0; id < CharIndex::TrackedCount; ++id) {
+                    out.charTotals[id].total += r.chars[id].total;
+                    out.charTotals[id].err += r.chars[id].err;
+                }
+                out.records.append(r);
+            }
+        }
+        p = eol + 1;
+    }
+}
+
+// Moves p to the start of the next line (or end)
+const char *nextLine(const char *p, const char *end)
+{
+    const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    return eol ? eol + 1 : end;
+}
+}
+
+LegacyCsvLoader::Result LegacyCsvLoader::load(const QString &path, int threads)
+{
+    Result result;
+    result.charTotals.fill(CharTotals());
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return result;
+    qint64 size = file.size();
+    if (size <= 0) return result;
+
+    // Map the file; fall back to reading it if mapping is not possible
+    QByteArray fallback;
+    const char *data = reinterpret_cast<const char *>(file.map(0, size));
+    if (!data) {
+        fallback = file.readAll();
+        data = fallback.constData();
+        size = fallback.size();
+    }
+    const char *end = data + size;
+
+    // Header: resolve every CSV field to a store column
+    const char *body = nextLine(data, end);
+    QString headerLine = QString::fromUtf8(data, int(body - data)).trimmed();
+    // Older versions wrote the comma column as ",_Total", breaking the split
+    headerLine.replace(",,_Total", ",COMMA_Total");
+    headerLine.replace(",,_OK", ",COMMA_OK");
+    headerLine.replace(",,_Err", ",COMMA_Err");
+    const QStringList headers = headerLine.split(",");
+    QVector<int> columns(headers.size(), -1);
+    for (int i = 0; i < headers.size(); ++i) columns[i] = SessionStore::columnForName(headers[i]);
+
+    // Row-aligned chunks, one per thread
+    int n = threads > 0 ? threads : QThread::idealThreadCount();
+    if (end - body < kMinParallelBytes) n = 1;
+    n = qMax(1, n);
+    QVector<const char *> bounds(n + 1);
+    bounds[0] = body;
+    bounds[n] = end;
+    for (int k = 1; k < n; ++k) {
+        const char *pos = body + (end - body) * k / n;
+        pos = qMax(pos, bounds[k - 1]);
+        bounds[k] = pos > body ? nextLine(pos - 1, end) : body;
+    }
+
+    QVector<Result> partial(n);
+    for (Result &r : partial) r.charTotals.fill(CharTotals());
+
+    // Workers take chunks 1..n-1, this thread parses chunk 0
+    std::vector<std::unique_ptr<QThread>> workers;
+    for (int k = 1; k < n; ++k) {
+        workers.emplace_back(QThread::create([&, k]() {
+            parseChunk(bounds[k], bounds[k + 1], columns, partial[k]);
+        }));
+        workers.back()->start();
+    }
+    parseChunk(bounds[0], bounds[1], columns, partial[0]);
+    for (auto &w : workers) w->wait();
+
+    // Merge in file order
+    int total = 0;
+    for (const Result &r : partial) total += r.records.size();
+    result.records.reserve(total);
+    for (const Result &r : partial) {
+        result.records.append(r.records);
+        result.skippedLines += r.skippedLines;
+        for (int id = 0; id < CharIndex::TrackedCount; ++id) {
+            result.charTotals[id].total += r.charTotals[id].total;
+            result.charTotals[id].err += r.charTotals[id].err;
+        }
+    }
+
+    if (fallback.isEmpty()) file.unmap(reinterpret_cast<uchar *>(const_cast<char *>(data)));
+    return result;
+}
+
+LegacyCsvLoader::Result LegacyCsvLoader::loadAll(const QStringList &paths, int threads)
+{
+    Result result;
+    result.charTotals.fill(CharTotals());
+    for (const QString &path : paths) {
+        Result part = load(path, threads);
+        result.records.append(part.records);
+        result.skippedLines += part.skippedLines;
+    }
+
+    // One combined timeline; a session present in two files is kept once
+    std::stable_sort(result.records.begin(), result.records.end(), [](const SessionRecord &a, const SessionRecord &b) {
+        return a.start < b.start;
+    });
+    auto last = std::unique(result.records.begin(), result.records.end(), [](const SessionRecord &a, const SessionRecord &b) {
+        return a.start == b.start && a.attempts == b.attempts && a.correct == b.correct;
+    });
+    result.records.erase(last, result.records.end());
+
+    for (const SessionRecord &r : result.records) {
+        for (int id = 0; id < CharIndex::TrackedCount; ++id) {
+            result.charTotals[id].total += r.chars[id].total;
+            result.charTotals[id].err += r.chars[id].err;
+        }
+    }
+    return result;
+}
+
+QStringList LegacyCsvLoader::legacyFiles(const QString &dir)
+{
+    QDir d(dir);
+    QStringList files;
+    // Backups are older, so they go first
+    const QStringList backups = d.entryList({"statistics_backup_*.csv"}, QDir::Files, QDir::Name);
+    for (const QString &name : backups) files.append(d.filePath(name));
+    if (d.exists(SessionStore::legacyCsvFile())) files.append(d.filePath(SessionStore::legacyCsvFile()));
+    return files;
+}
+
+bool LegacyCsvLoader::importIntoStore(const QString &storePath)
+{
+    if (QFile::exists(storePath)) return false;
+    const QStringList files = legacyFiles(QFileInfo(storePath).absolutePath());
+    if (files.isEmpty()) return false;
+
+    Result result = loadAll(files);
+    if (!SessionStore::writeStore(storePath, result.records)) return false;
+
+    // Keep the originals, but never import them twice
+    for (const QString &path : files) {
+        if (!QFile::rename(path, path + ".imported")) qWarning() << "Could not rename imported file" << path;
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef LEGACYCSVLOADER_H
+#define LEGACYCSVLOADER_H
+
+// Include standard Qt classes for strings and containers
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <array>
+#include "SessionStore.h"
+#include "StatsIndex.h"
+
+// Fast loader for the legacy statistics.csv format (and the
+// statistics_backup_*.csv files older versions left behind).
+// The file is memory-mapped and split into row-aligned chunks that are parsed
+// in parallel with a hand-rolled field splitter and numeric parser; each
+// thread produces its own records and character totals, which are merged in
+// file order at the end.
+class LegacyCsvLoader
+{
+public:
+    struct Result {
+        QVector<SessionRecord> records; // In file order (or start-time order for loadAll)
+        std::array<CharTotals, CharIndex::TrackedCount> charTotals; // Sum over all records
+        qint64 skippedLines = 0;        // Malformed rows
+    };
+
+    // Loads one CSV file. threads = 0 picks QThread::idealThreadCount().
+    static Result load(const QString &path, int threads = 0);
+
+    // Loads several files into one history sorted by start time, dropping duplicates
+    static Result loadAll(const QStringList &paths, int threads = 0);
+
+    // statistics.csv plus every statistics_backup_*.csv in a directory
+    static QStringList legacyFiles(const QString &dir = QStringLiteral("."));
+
+    // One-time import: if the store does not exist yet, ingest all legacy
+    // files found next to it and rename each to *.imported.
+    static bool importIntoStore(const QString &storePath = SessionStore::defaultFile());
+};
+
+#endif // LEGACYCSVLOADER_H
@@ -1,10 +1,31 @@
 #include "MainWindow.h"
 #include "MorseUtils.h"
+#include "SessionStore.h"
+#include "StatsIndex.h"
 #include <QMessageBox>
 #include <QTimer>
 #include <QButtonGroup>
-#include <QRandomGenerator>
+#include <QDateTime>
 #include <QDebug>
+#include <QSettings>
+#include <QWindow>
+#include <functional>
+
+namespace {
+// Combo box that runs a callback just before its list opens, so an
+// expensive list can be filled on demand
+class OnDemandComboBox : public QComboBox
+{
+public:
+    std::function<void()> beforePopup;
+
+    void showPopup() override
+    {
+        if (beforePopup) beforePopup();
+        QComboBox::showPopup();
+    }
+};
+}
 
 // Constructor for MainWindow
 // Initializes the base class and component classes (Serial, Sound, Tracker)
@@ -12,45 +33,164 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), 
       m_serial(new SerialManager(this)), 
       m_sound(new SoundGenerator(this)),
-      m_tracker(new StatisticsTracker())
+      m_tracker(m_engine.tracker())
 {
+    m_startupTimer.start();
     // Build the UI
     setupUi();
     // Connect Signals and Slots
     setupConnections();
-    // Populate the ports list
-    refreshPorts();
-    
-    // Populate Audio Devices
-    const auto devices = QMediaDevices::audioOutputs();
-    for (const auto &device : devices) {
-        m_comboAudioDevice->addItem(device.description(), QVariant::fromValue(device));
-    }
-    // Select default
-    m_comboAudioDevice->setCurrentIndex(0); // Simplification: Just pick first (usually default)
     
     // Initialize Drill Timer
     m_drillTimer = new QTimer(this);
     m_drillTimer->setSingleShot(true);
     connect(m_drillTimer, &QTimer::timeout, this, &MainWindow::sendNextDrillChar);
+    
+    // Continuous copy: next chunk when the device should be done keying,
+    // and a periodic commit so unanswered groups are scored too
+    m_streamChunkTimer = new QTimer(this);
+    m_streamChunkTimer->setSingleShot(true);
+    connect(m_streamChunkTimer, &QTimer::timeout, this, &MainWindow::playNextChunk);
+    m_streamTimer = new QTimer(this);
+    m_streamTimer->setInterval(250);
+    connect(m_streamTimer, &QTimer::timeout, this, [this]() { commitStream(false); });
+
+    // Device text reaches the widgets at most once per frame
+    m_rxFlushTimer = new QTimer(this);
+    m_rxFlushTimer->setSingleShot(true);
+    m_rxFlushTimer->setInterval(16);
+    connect(m_rxFlushTimer, &QTimer::timeout, this, &MainWindow::flushSerialText);
 
     // Initial state
     toggleOfflineUi();
     toggleDrillUi();
     toggleSpacingUi();
+    
+    // Nothing to drill until the engine is loaded
+    m_btnPlay->setEnabled(false);
+    m_btnCheck->setEnabled(false);
+    m_lblKochStatus->setText("Loading...");
+    // The port used last time is offered right away; the full list follows
+    const QString lastPort = QSettings().value("serial/port").toString();
+    if (!lastPort.isEmpty()) m_portCombo->addItem(lastPort);
+    logStartupPhase("widgets");
+    
+    // Port enumeration, the engine (statistics store, Koch lesson, review
+    // history, word lists, training text) and the statistics index load off
+    // the GUI thread, so the window paints at once
+    m_loader = QThread::create([this]() {
+        QElapsedTimer timer;
+        timer.start();
+        m_loadedPorts = SerialManager::getAvailablePorts();
+        m_loadPortsMs = timer.restart();
+        m_engine.load();
+        m_loadEngineMs = timer.restart();
+        // Bring the statistics index up to date now, so the statistics
+        // window only has to read it
+        SessionStore store;
+        StatsIndex index;
+        index.load();
+        store.open();
+        if (index.sync(store)) index.save();
+        m_loadStatsMs = timer.elapsed();
+    });
+    connect(m_loader, &QThread::finished, this, &MainWindow::onStartupLoaded);
+    m_loader->start();
+}
+
+// Watch the native window for its first expose: the widgets paint while it
+// is handled, so a call queued from there runs after the first frame
+void MainWindow::showEvent(QShowEvent *event)
+{
+    QMainWindow::showEvent(event);
+    if (!m_firstPaintLogged && windowHandle()) windowHandle()->installEventFilter(this);
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == windowHandle() && event->type() == QEvent::Expose && windowHandle()->isExposed()) {
+        windowHandle()->removeEventFilter(this);
+        if (!m_firstPaintLogged) {
+            m_firstPaintLogged = true;
+            QTimer::singleShot(0, this, [this]() { logStartupPhase("first paint"); });
+        }
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+// Startup work from the loader thread is done
+void MainWindow::onStartupLoaded()
+{
+    m_loader->deleteLater();
+    m_loader = nullptr;
+    
+    fillPorts(m_loadedPorts);
+    m_engineReady = true;
+    m_btnPlay->setEnabled(true);
+    m_btnCheck->setEnabled(true);
+    updateKochStatus();
+    
+    qInfo().noquote() << QString("Startup: background ports %1 ms, engine %2 ms, statistics %3 ms")
+                         .arg(m_loadPortsMs).arg(m_loadEngineMs).arg(m_loadStatsMs);
+    logStartupPhase("ready");
+}
+
+// List the audio outputs and select the one used last time
+void MainWindow::populateAudioDevices()
+{
+    m_audioDevicesListed = true;
+    QElapsedTimer timer;
+    timer.start();
+    
+    const QByteArray lastId = QSettings().value("audio/device").toByteArray();
+    const QByteArray defaultId = QMediaDevices::defaultAudioOutput().id();
+    const auto devices = QMediaDevices::audioOutputs();
+    int selected = -1;
+    {
+        // Filling the list must not overwrite the remembered device
+        QSignalBlocker blocker(m_comboAudioDevice);
+        m_comboAudioDevice->clear();
+        for (const auto &device : devices) {
+            m_comboAudioDevice->addItem(device.description(), QVariant::fromValue(device));
+            if (device.id() == lastId || (selected < 0 && device.id() == defaultId)) {
+                selected = m_comboAudioDevice->count() - 1;
+            }
+        }
+        selected = qMax(0, selected);
+        m_comboAudioDevice->setCurrentIndex(selected);
+    }
+    onAudioDeviceChanged(selected);
+    
+    qInfo().noquote() << QString("%1 audio outputs listed in %2 ms")
+                         .arg(devices.size()).arg(timer.elapsed());
+}
+
+void MainWindow::logStartupPhase(const QString &phase)
+{
+    qInfo().noquote() << QString("Startup: %1 after %2 ms").arg(phase).arg(m_startupTimer.elapsed());
 }
 
 // Destructor
-// Clean up manually allocated non-child objects
+// Child widgets and the engine clean up after themselves
 MainWindow::~MainWindow()
 {
-    delete m_tracker; // StatisticsTracker is not a QObject child, so delete manually
+    // The loader works on the engine; let it finish first
+    if (m_loader) {
+        m_loader->wait();
+        delete m_loader;
+    }
 }
 
 // Handle Window Close Event
 // Saves statistics before the application exits
 void MainWindow::closeEvent(QCloseEvent *event)
 {
+    // The session is only saved once the engine has loaded
+    if (m_loader) m_loader->wait();
+    
+    // Score what is left of a continuous copy stream
+    stopContinuous();
+    
     // Gather current session parameters for stats
     int wpm = m_spinOfflineWpm->value();
     int tone = m_spinOfflineTone->value();
@@ -164,14 +304,28 @@ void MainWindow::setupDashboard(QWidget *parent)
     // RX (Receive) Area
     QGroupBox *rxBox = new QGroupBox("Inbox (RX from Paddle)");
     QVBoxLayout *rxLayout = new QVBoxLayout(rxBox);
-    m_txtRx = new QTextEdit();
-    m_txtRx->setReadOnly(true); // User cannot type here directly
-    rxLayout->addWidget(m_txtRx);
+    // Bounded line buffer shown by a view that only draws the visible lines
+    m_rxLog = new RxLogModel(RxLogModel::DefaultMaxLines, this);
+    m_rxView = new RxLogView();
+    m_rxView->setModel(m_rxLog);
+    rxLayout->addWidget(m_rxView);
+    
+    QHBoxLayout *rxControls = new QHBoxLayout();
+    // Line cap of the log
+    rxControls->addWidget(new QLabel("Keep Lines:"));
+    QSpinBox *spinRxLines = new QSpinBox();
+    spinRxLines->setRange(100, 100000);
+    spinRxLines->setSingleStep(1000);
+    spinRxLines->setValue(RxLogModel::DefaultMaxLines);
+    connect(spinRxLines, &QSpinBox::valueChanged, m_rxLog, &RxLogModel::setMaxLines);
+    rxControls->addWidget(spinRxLines);
+    rxControls->addStretch();
     
     // Clear Log Button
     QPushButton *btnClearRx = new QPushButton("Clear Log");
     connect(btnClearRx, &QPushButton::clicked, this, &MainWindow::clearRxLog);
-    rxLayout->addWidget(btnClearRx);
+    rxControls->addWidget(btnClearRx);
+    rxLayout->addLayout(rxControls);
     termLayout->addWidget(rxBox);
     
     // TX (Transmit) Area
@@ -202,16 +356,49 @@ void MainWindow::setupTrainer(QWidget *parent)
     cfgLayout->addWidget(new QLabel("Mode:"), 0, 0);
     m_radioModeWords = new QRadioButton("Meaningful Words");
     m_radioModeRandom = new QRadioButton("Random Characters");
+    m_radioModeKoch = new QRadioButton("Koch Method");
+    m_radioModeQso = new QRadioButton("Callsigns / QSO");
+    m_radioModeText = new QRadioButton("Plain Text");
     m_radioModeWords->setChecked(true);
     
     // Group Buttons for logic exclusion
     QButtonGroup *grpMode = new QButtonGroup(this);
     grpMode->addButton(m_radioModeWords);
     grpMode->addButton(m_radioModeRandom);
+    grpMode->addButton(m_radioModeKoch);
+    grpMode->addButton(m_radioModeQso);
+    grpMode->addButton(m_radioModeText);
+    
+    // What the Callsigns / QSO mode sends
+    m_comboQsoKind = new QComboBox();
+    m_comboQsoKind->addItem("Callsigns", int(QsoKind::Callsign));
+    m_comboQsoKind->addItem("Contest (Serial)", int(QsoKind::SerialExchange));
+    m_comboQsoKind->addItem("Contest (CQ Zone)", int(QsoKind::ZoneExchange));
+    m_comboQsoKind->addItem("Ragchew QSO", int(QsoKind::Ragchew));
+    m_comboQsoKind->setEnabled(false);
+    connect(m_radioModeQso, &QRadioButton::toggled, m_comboQsoKind, &QComboBox::setEnabled);
+    
+    // How the Plain Text mode strings its text together
+    m_comboTextLevel = new QComboBox();
+    m_comboTextLevel->addItem("Letter Model", int(MarkovTextGenerator::Level::Character));
+    m_comboTextLevel->addItem("Word Model", int(MarkovTextGenerator::Level::Word));
+    m_comboTextLevel->setToolTip("Generated from the .txt files in the texts folder; Group Size sets the number of words");
+    m_comboTextLevel->setEnabled(false);
+    connect(m_radioModeText, &QRadioButton::toggled, m_comboTextLevel, &QComboBox::setEnabled);
+    
+    // Koch progress (lesson, characters, rolling accuracy)
+    m_lblKochStatus = new QLabel();
+    m_lblKochStatus->setStyleSheet("color: #555;");
     
     QHBoxLayout *modeLayout = new QHBoxLayout();
     modeLayout->addWidget(m_radioModeWords);
     modeLayout->addWidget(m_radioModeRandom);
+    modeLayout->addWidget(m_radioModeKoch);
+    modeLayout->addWidget(m_radioModeQso);
+    modeLayout->addWidget(m_comboQsoKind);
+    modeLayout->addWidget(m_radioModeText);
+    modeLayout->addWidget(m_comboTextLevel);
+    modeLayout->addWidget(m_lblKochStatus, 1);
     cfgLayout->addLayout(modeLayout, 0, 1, 1, 3);
     
     // Group and Set Size Inputs (For Random Mode)
@@ -254,11 +441,26 @@ void MainWindow::setupTrainer(QWidget *parent)
     // Spacing Checkbox
     m_chkIgnoreSpacing = new QCheckBox("Ignore Spacing");
     cfgLayout->addWidget(m_chkIgnoreSpacing, 4, 0, 1, 2);
+    
+    // Adaptive random groups
+    m_chkAdaptive = new QCheckBox("Focus on Weak Characters");
+    m_chkAdaptive->setToolTip("Random groups favour characters you miss or recognise slowly");
+    cfgLayout->addWidget(m_chkAdaptive, 4, 2, 1, 2);
+
+    // Spaced repetition of characters and words that are due for review
+    m_chkReview = new QCheckBox("Spaced Repetition");
+    m_chkReview->setToolTip("Mix characters and words that are due for review into the drills");
+    cfgLayout->addWidget(m_chkReview, 5, 0, 1, 2);
+    
+    // Continuous copy: an endless RX stream scored while you type
+    m_chkContinuous = new QCheckBox("Continuous Copy");
+    m_chkContinuous->setToolTip("RX drills play group after group while you type; press Check to stop");
+    cfgLayout->addWidget(m_chkContinuous, 5, 2, 1, 2);
 
     // Custom Spacing (Farnsworth)
     m_chkAdjustableSpacing = new QCheckBox("Adjustable Time Spacing");
     m_chkAdjustableSpacing->setToolTip("Add extra delay between characters (Farnsworth style)");
-    cfgLayout->addWidget(m_chkAdjustableSpacing, 5, 0, 1, 2);
+    cfgLayout->addWidget(m_chkAdjustableSpacing, 6, 0, 1, 2);
     
     m_spacingContainer = new QWidget();
     QHBoxLayout *spacingControls = new QHBoxLayout(m_spacingContainer);
@@ -269,12 +471,12 @@ void MainWindow::setupTrainer(QWidget *parent)
     m_spinSpacingMs->setValue(500); // Default 500ms
     m_spinSpacingMs->setSingleStep(50);
     spacingControls->addWidget(m_spinSpacingMs);
-    cfgLayout->addWidget(m_spacingContainer, 5, 2, 1, 2);
+    cfgLayout->addWidget(m_spacingContainer, 6, 2, 1, 2);
     
     // Offline Checkbox and Controls
     m_chkOffline = new QCheckBox("Work Offline (PC Audio)");
     connect(m_chkOffline, &QCheckBox::toggled, this, &MainWindow::toggleOfflineUi);
-    cfgLayout->addWidget(m_chkOffline, 6, 0, 1, 2);
+    cfgLayout->addWidget(m_chkOffline, 7, 0, 1, 2);
     
     // Offline Controls (WPM/Tone) container
     m_offlineControlsInfo = new QWidget();
@@ -292,7 +494,7 @@ void MainWindow::setupTrainer(QWidget *parent)
     m_spinOfflineTone->setValue(700);
     offLayout->addWidget(m_spinOfflineTone);
     
-    cfgLayout->addWidget(m_offlineControlsInfo, 6, 2, 1, 2);
+    cfgLayout->addWidget(m_offlineControlsInfo, 7, 2, 1, 2);
     
     // PC Audio Controls (Device + Volume)
     QGroupBox *audioBox = new QGroupBox("PC Audio Settings");
@@ -300,7 +502,17 @@ void MainWindow::setupTrainer(QWidget *parent)
     
     // Device Selector
     audioLayout->addWidget(new QLabel("Output Device:"));
-    m_comboAudioDevice = new QComboBox();
+    // Listing the outputs can block for a while on some audio backends, so
+    // the device used last time is shown by name and the list is only
+    // filled when it is opened
+    OnDemandComboBox *audioCombo = new OnDemandComboBox();
+    audioCombo->beforePopup = [this]() { if (!m_audioDevicesListed) populateAudioDevices(); };
+    m_comboAudioDevice = audioCombo;
+    const QByteArray lastDevice = QSettings().value("audio/device").toByteArray();
+    m_comboAudioDevice->addItem(lastDevice.isEmpty() ? QString("System default")
+                                                     : QSettings().value("audio/deviceName").toString());
+    // Resolved from its id the first time something plays
+    if (!lastDevice.isEmpty()) m_sound->setAudioDeviceId(lastDevice);
     audioLayout->addWidget(m_comboAudioDevice);
     
     // Volume Slider
@@ -310,7 +522,7 @@ void MainWindow::setupTrainer(QWidget *parent)
     m_sliderVolume->setValue(100);
     audioLayout->addWidget(m_sliderVolume);
     
-    cfgLayout->addWidget(audioBox, 7, 0, 1, 4);
+    cfgLayout->addWidget(audioBox, 8, 0, 1, 4);
 
     layout->addWidget(cfgBox);
     
@@ -372,8 +584,8 @@ void MainWindow::setupConnections()
 {
     // Connect Button
     connect(m_btnConnect, &QPushButton::clicked, this, &MainWindow::toggleConnection);
-    // Serial Line Received -> update UI
-    connect(m_serial, &SerialManager::lineReceived, this, &MainWindow::onSerialLineReceived);
+    // Serial System Line Received -> update dashboard (kept out of the RX log)
+    connect(m_serial, &SerialManager::systemLineReceived, this, &MainWindow::onSystemLineReceived);
     // Serial Text Received -> update RX log immediately
     connect(m_serial, &SerialManager::textReceived, this, &MainWindow::onSerialTextReceived);
     
@@ -413,6 +625,10 @@ void MainWindow::setupConnections()
     connect(m_btnCheck, &QPushButton::clicked, this, &MainWindow::checkAnswer);
     // Enter key in answer box -> Verify Answer
     connect(m_entAnswer, &QLineEdit::returnPressed, this, &MainWindow::checkAnswer);
+    // Timestamp every keystroke (and every decoded character in TX mode)
+    connect(m_entAnswer, &QLineEdit::textChanged, this, &MainWindow::stampAnswer);
+    // Continuous copy: the next chunk follows the one just played
+    connect(m_sound, &SoundGenerator::playbackFinished, this, &MainWindow::playNextChunk);
     
     // Audio Controls
     connect(m_sliderVolume, &QSlider::valueChanged, this, &MainWindow::onVolumeChanged);
@@ -421,9 +637,17 @@ void MainWindow::setupConnections()
 
 // Refresh Serial Ports List
 void MainWindow::refreshPorts()
+{
+    fillPorts(SerialManager::getAvailablePorts());
+}
+
+void MainWindow::fillPorts(const QStringList &ports)
 {
     m_portCombo->clear();
-    m_portCombo->addItems(m_serial->getAvailablePorts());
+    m_portCombo->addItems(ports);
+    // Select the port used last time
+    int last = m_portCombo->findText(QSettings().value("serial/port").toString());
+    if (last >= 0) m_portCombo->setCurrentIndex(last);
 }
 
 // Connect/Disconnect Serial Port
@@ -441,6 +665,7 @@ void MainWindow::toggleConnection()
         int baud = m_baudCombo->currentText().toInt();
         
         if (m_serial->connectToPort(port, baud)) {
+            QSettings().setValue("serial/port", port);
             m_btnConnect->setText("Disconnect");
             m_lblStatus->setText("CONNECTED");
             m_lblStatus->setStyleSheet("color: green; font-weight: bold;");
@@ -451,91 +676,59 @@ void MainWindow::toggleConnection()
     }
 }
 
-// Handle incoming serial line
-void MainWindow::onSerialLineReceived(QString line)
+// Handle a status line of the device (classified by SerialManager)
+void MainWindow::onSystemLineReceived(SerialManager::SystemMessage kind, QString value, QString line)
 {
     // Parse Status Updates and update dashboard labels
-    bool isSystemMsg = false;
-    QString textToRemove;
-    
-    if (line.contains("WPM set to")) {
-        QString val = line.section("WPM set to", 1, 1).trimmed();
-        m_lblDashWpm->setText("Speed: " + val + " WPM");
-        m_tracker->setCurrentWpm(val.toInt());
-        isSystemMsg = true;
-        textToRemove = "WPM set to " + val;
-    }
-    else if (line.contains("Tone set to")) {
-        QString val = line.section("Tone set to", 1, 1).trimmed();
-        m_lblDashTone->setText("Tone: " + val + " Hz");
-        isSystemMsg = true;
-        textToRemove = "Tone set to " + val;
-    }
-    else if (line.contains("Mode set to")) {
-        QString val = line.section("Mode set to", 1, 1).trimmed();
-        m_lblDashMode->setText("Mode: " + val);
-        isSystemMsg = true;
-        textToRemove = "Mode set to " + val;
-    }
-    else if (line.contains("Action:")) {
-        // e.g. "Action: Buffer Cleared" - just log it as system msg
-        isSystemMsg = true;
-        textToRemove = line; // Remove the whole line for actions
-    }
-    else if (line.startsWith("\nEncoded:")) {
-        // Spoiler prevention! Hide the answer from the log.
-        isSystemMsg = true;
-        textToRemove = line;
-    }
-    else if (line.contains("[Done]")) {
-        // Spoiler prevention! Hide the done message.
-        isSystemMsg = true;
-        textToRemove = line;
+    switch (kind) {
+    case SerialManager::SystemMessage::WpmSet:
+        m_lblDashWpm->setText("Speed: " + value + " WPM");
+        m_tracker->setCurrentWpm(value.toInt());
+        break;
+    case SerialManager::SystemMessage::ToneSet:
+        m_lblDashTone->setText("Tone: " + value + " Hz");
+        break;
+    case SerialManager::SystemMessage::ModeSet:
+        m_lblDashMode->setText("Mode: " + value);
+        break;
+    default:
+        // "Action:" lines are just logged; "Encoded:" and "[Done]" would
+        // spoil the answer, so they too only show on request
+        break;
     }
 
-    // New Filter Logic: Retroactive Removal
-    // Since we display text immediately (including system msgs), 
-    // we now check if we should have hidden this message, and if so, delete it from the log.
-    if (isSystemMsg && !m_chkShowSys->isChecked() && !textToRemove.isEmpty()) {
-        QTextCursor cursor = m_txtRx->textCursor();
-        cursor.movePosition(QTextCursor::End);
-        
-        QTextDocument *doc = m_txtRx->document();
-        // Search backwards from the end to find the most recent occurrence
-        QTextCursor highlight = doc->find(textToRemove, cursor, QTextDocument::FindBackward);
-        
-        if (!highlight.isNull()) {
-            highlight.removeSelectedText();
-            // Optional: Also try to remove a trailing newline if left behind
-            // This is a simple cleanup to avoid leaving empty lines
-            QTextCursor cleanupCursor = m_txtRx->textCursor();
-            cleanupCursor.movePosition(QTextCursor::End);
-            // Select the last character
-            cleanupCursor.movePosition(QTextCursor::PreviousCharacter, QTextCursor::KeepAnchor);
-            }
-        }
+    // System lines never reach the log unless asked for; text received
+    // before the line goes out first so the log keeps the device's order
+    if (m_chkShowSys->isChecked()) {
+        flushSerialText();
+        m_rxLog->append(line + '\n');
     }
+}
 
 // Handle raw text for immediate display
 void MainWindow::onSerialTextReceived(QString text)
 {
-    // Append to RX Log
-    m_txtRx->moveCursor(QTextCursor::End);
-    m_txtRx->insertPlainText(text);
-    m_txtRx->ensureCursorVisible();
+    // Collect until the next frame; a burst of reads costs one widget update
+    m_pendingRx += text;
+    if (!m_rxFlushTimer->isActive()) m_rxFlushTimer->start();
+}
+
+void MainWindow::flushSerialText()
+{
+    m_rxFlushTimer->stop();
+    if (m_pendingRx.isEmpty()) return;
+    const QString text = m_pendingRx;
+    m_pendingRx.clear();
+
+    // Append to RX Log (the view follows the end by itself)
+    m_rxLog->append(text);
 
     // In TX Mode, route paddle input to Answer Box
+    // (status lines such as "Encoded:" never get here, see SerialManager)
     if (m_radioTx->isChecked()) {
-        QString current = m_entAnswer->text() + text;
-        
-        // Sanitize "Encoded:" artifact which might arrive in chunks
-        // e.g. "Enc" + "oded: A" -> "Encoded: A" -> "A"
-        current.replace("Encoded:", "", Qt::CaseInsensitive);
-        // Also remove just "Encoded" if it appears as a whole word (though rare to have without colon)
-        // Actually, let's keep it simple. If "Encoded:" is the prefix, remove it.
-        
-        // Update the box
-        m_entAnswer->setText(current);
+        // Only the new text is inserted, so the cost does not grow with the answer
+        m_entAnswer->end(false);
+        m_entAnswer->insert(text);
     }
 
     // Echo to Audio if Offline Mode is on (PC Sidetone)
@@ -553,8 +746,8 @@ void MainWindow::onSerialTextReceived(QString text)
          if (!isSystem) {
              int wpm = m_spinOfflineWpm->value();
              int tone = m_spinOfflineTone->value();
-             // Play with 0 extra spacing for immediate feedback
-             m_sound->playMorse(text, wpm, tone, 0); 
+             // Queue behind what is still playing, with 0 extra spacing for immediate feedback
+             m_sound->appendMorse(text, wpm, tone, 0);
          }
     }
 }
@@ -590,43 +783,59 @@ void MainWindow::toggleSpacingUi()
     }
 }
 
+// Read the drill settings from the configuration card
+DrillSettings MainWindow::drillSettings() const
+{
+    DrillSettings settings;
+    if (m_radioModeKoch->isChecked()) settings.mode = DrillMode::Koch;
+    else if (m_radioModeQso->isChecked()) settings.mode = DrillMode::Qso;
+    else if (m_radioModeText->isChecked()) settings.mode = DrillMode::Text;
+    else if (m_radioModeWords->isChecked()) settings.mode = DrillMode::Words;
+    settings.groupSize = m_spinGroupSize->value();
+    settings.allowedChars = m_lineAllowedChars->text();
+    settings.adaptive = m_chkAdaptive->isChecked();
+    settings.review = m_chkReview->isChecked();
+    settings.ignoreSpacing = m_chkIgnoreSpacing->isChecked();
+    settings.qsoKind = QsoKind(m_comboQsoKind->currentData().toInt());
+    settings.textLevel = MarkovTextGenerator::Level(m_comboTextLevel->currentData().toInt());
+    return settings;
+}
+
 // Generate a target string for the drill
 QString MainWindow::generateTarget()
 {
-    if (m_radioModeWords->isChecked()) {
-        // Words Mode: Pick a random word from the utils list
-        QStringList words = MorseUtils::getTrainingWords();
-        int idx = QRandomGenerator::global()->bounded(words.size());
-        return words[idx];
-    } else {
-        // Random Characters Mode
-        int len = m_spinGroupSize->value();
-        QString allowed = m_lineAllowedChars->text().toUpper();
-        if (allowed.isEmpty()) allowed = "PARIS"; // Fallback
-        
-        QString res = "";
-        for (int i=0; i<len; ++i) {
-            int idx = QRandomGenerator::global()->bounded(allowed.length());
-            res.append(allowed[idx]);
-        }
-        return res;
-    }
+    return m_engine.generateTarget(drillSettings());
 }
 
 // Start a drill
 void MainWindow::playDrill()
 {
+    // The engine is still loading
+    if (!m_engineReady) return;
+    
+    // Continuous copy runs its own stream (RX only)
+    if (m_chkContinuous->isChecked() && m_radioRx->isChecked()) {
+        startContinuous();
+        return;
+    }
+    if (m_streamActive) stopContinuous();
+    
     // 1. Generate Target
     m_currentTarget = generateTarget();
-    // 2. Clear previous answer/UI
+    // 2. Clear previous answer/UI (device text from before the drill goes with it)
+    flushSerialText();
     m_entAnswer->clear();
     m_lblFeedback->setText("Playing...");
     m_lblFeedback->setStyleSheet("color: black; font-weight: bold;");
     
+    m_cueEndMs.clear();
+    m_targetShownMs = 0;
+    
     if (m_radioTx->isChecked()) {
         // TX Mode: Show target immediately, don't play audio
         m_lblTargetBig->setText(m_currentTarget);
         m_lblFeedback->setText("Go ahead! Key it.");
+        m_targetShownMs = QDateTime::currentMSecsSinceEpoch();
     } else {
         // RX Mode: Hide target, play audio
         m_lblTargetBig->clear();
@@ -643,8 +852,15 @@ void MainWindow::playDrill()
              
              m_sound->playMorse(m_currentTarget, wpm, tone, extraSpacing);
              m_tracker->setCurrentWpm(wpm);
+             for (const CharTiming &t : m_sound->lastSchedule()) m_cueEndMs.append(t.endMs);
         } else {
              // Online Mode (External Device)
+             // The device keys at its own speed; estimate when each character is heard
+             int extraSpacing = m_chkAdjustableSpacing->isChecked() ? m_spinSpacingMs->value() : 0;
+             const QVector<CharTiming> timing = MorseSynth::schedule(m_currentTarget, m_tracker->getCurrentWpm(),
+                                                                         extraSpacing, QDateTime::currentMSecsSinceEpoch());
+             for (const CharTiming &t : timing) m_cueEndMs.append(t.endMs);
+             
              if (m_chkAdjustableSpacing->isChecked()) {
                  // Use Client-Side Spacing
                  m_pendingDrillText = m_currentTarget;
@@ -714,27 +930,40 @@ void MainWindow::sendNextDrillChar()
 // Check the user's answer
 void MainWindow::checkAnswer()
 {
+    // Enter in the answer box gets here even while the engine is loading
+    if (!m_engineReady) return;
+    
+    // In continuous copy, Check ends the stream
+    if (m_streamActive) {
+        stopContinuous();
+        return;
+    }
+    
+    // Device text still waiting for its frame belongs to this answer
+    flushSerialText();
+    
     // Normalize user input
     QString ans = m_entAnswer->text();
     // Safety sanitize
     ans.replace("Encoded:", "", Qt::CaseInsensitive);
     ans = ans.trimmed().toUpper();
     
+    // Keystroke times of the normalized answer (leading blanks were trimmed off)
+    AttemptTiming timing;
+    QString raw = m_entAnswer->text();
+    int lead = 0;
+    while (lead < raw.length() && raw[lead].isSpace()) ++lead;
+    if (raw.mid(lead).trimmed().toUpper() == ans && m_keyTimes.size() == raw.length()) {
+        timing.keyMs = m_keyTimes.mid(lead, ans.length());
+        timing.cueEndMs = m_cueEndMs;
+        timing.shownMs = m_targetShownMs;
+    }
+    
     // Compare Match
     // Live Stats Update
-    m_tracker->recordAttempt(m_currentTarget, ans);
-    
-    // Comparison Logic
-    QString finalAns = ans;
-    QString finalTarget = m_currentTarget;
-    
-    // Handle Ignore Spacing
-    if (m_chkIgnoreSpacing->isChecked()) {
-        finalAns.replace(" ", "");
-        finalTarget.replace(" ", "");
-    }
+    bool unlocked = scoreAttempt(m_currentTarget, ans, timing);
     
-    if (finalAns == finalTarget) {
+    if (answerMatches(m_currentTarget, ans)) {
         m_lblFeedback->setText("CORRECT! ✅");
         m_lblFeedback->setStyleSheet("color: green; font-weight: bold;");
     } else {
@@ -742,6 +971,10 @@ void MainWindow::checkAnswer()
         m_lblFeedback->setStyleSheet("color: red; font-weight: bold;");
     }
     
+    if (unlocked) {
+        m_lblFeedback->setText(m_lblFeedback->text() + "  New character: " + QString(m_engine.koch().newestChar()));
+    }
+    
     // Live Stats Update
     if (m_statsWindow && m_statsWindow->isVisible()) {
         m_statsWindow->refreshData();
@@ -751,6 +984,174 @@ void MainWindow::checkAnswer()
     m_entAnswer->clear();
 }
 
+// Record one attempt with the engine. Returns true if a Koch character was unlocked.
+bool MainWindow::scoreAttempt(const QString &target, const QString &ans, const AttemptTiming &timing)
+{
+    const DrillSettings settings = drillSettings();
+    AttemptResult result = m_engine.scoreAttempt(settings, target, ans, timing);
+    if (settings.mode == DrillMode::Koch) updateKochStatus();
+    return result.unlocked;
+}
+
+// Whether an answer counts as correct (honours Ignore Spacing)
+bool MainWindow::answerMatches(QString target, QString ans) const
+{
+    return TrainerEngine::answerMatches(drillSettings(), target, ans);
+}
+
+// Start a continuous copy stream
+void MainWindow::startContinuous()
+{
+    if (m_streamActive) stopContinuous();
+    m_stream.reset();
+    m_streamActive = true;
+    m_streamGroups = 0;
+    m_streamCorrect = 0;
+    
+    m_entAnswer->clear();
+    m_lblTargetBig->clear();
+    m_lblFeedback->setText("Continuous copy: type what you hear. Press Check to stop.");
+    m_lblFeedback->setStyleSheet("color: black; font-weight: bold;");
+    
+    playNextChunk();
+    m_streamTimer->start();
+}
+
+// End the stream and score whatever is still pending
+void MainWindow::stopContinuous()
+{
+    if (!m_streamActive) return;
+    m_streamActive = false;
+    m_streamTimer->stop();
+    m_streamChunkTimer->stop();
+    m_drillTimer->stop();
+    if (m_chkOffline->isChecked()) m_sound->stop();
+    
+    commitStream(true);
+    m_lblFeedback->setText(QString("Continuous copy stopped: %1 of %2 groups correct")
+                           .arg(m_streamCorrect).arg(m_streamGroups));
+    m_entAnswer->clear();
+}
+
+// Play the next generated chunk of the stream
+// Only one chunk is generated ahead, so the stream never exists as a whole
+void MainWindow::playNextChunk()
+{
+    if (!m_streamActive) return;
+    
+    // A leading space keeps a word gap between chunks
+    m_currentTarget = generateTarget();
+    QString text = " " + m_currentTarget;
+    int extraSpacing = m_chkAdjustableSpacing->isChecked() ? m_spinSpacingMs->value() : 0;
+    
+    QVector<qint64> cues;
+    if (m_chkOffline->isChecked()) {
+        int wpm = m_spinOfflineWpm->value();
+        m_sound->playMorse(text, wpm, m_spinOfflineTone->value(), extraSpacing);
+        m_tracker->setCurrentWpm(wpm);
+        // playbackFinished brings the next chunk
+        for (const CharTiming &t : m_sound->lastSchedule()) cues.append(t.endMs);
+    } else {
+        // The device keys at its own speed; the estimate also paces the next chunk
+        qint64 now = QDateTime::currentMSecsSinceEpoch();
+        const QVector<CharTiming> timing = MorseSynth::schedule(text, m_tracker->getCurrentWpm(), extraSpacing, now);
+        for (const CharTiming &t : timing) cues.append(t.endMs);
+        if (m_chkAdjustableSpacing->isChecked()) {
+            m_pendingDrillText = text;
+            m_drillCharIdx = 0;
+            sendNextDrillChar();
+        } else {
+            m_serial->sendCommand(text);
+        }
+        qint64 end = timing.isEmpty() ? now : timing.last().endMs;
+        m_streamChunkTimer->start(int(qMax<qint64>(0, end - now)));
+    }
+    m_stream.appendTarget(text, cues);
+}
+
+// Score the groups of the stream that are settled (all of them if final)
+void MainWindow::commitStream(bool final)
+{
+    const QVector<StreamSegment> segments = m_stream.commit(QDateTime::currentMSecsSinceEpoch(), final);
+    if (segments.isEmpty()) return;
+    
+    bool unlocked = false;
+    for (const StreamSegment &seg : segments) {
+        AttemptTiming timing;
+        timing.cueEndMs = seg.cueEndMs;
+        timing.keyMs = seg.keyMs;
+        unlocked |= scoreAttempt(seg.target, seg.typed, timing);
+        m_streamGroups++;
+        if (answerMatches(seg.target, seg.typed)) m_streamCorrect++;
+    }
+    
+    if (m_streamActive) {
+        const StreamSegment &last = segments.last();
+        QString text = QString("Continuous: %1 of %2 groups correct (last: '%3' -> '%4')")
+                       .arg(m_streamCorrect).arg(m_streamGroups).arg(last.target, last.typed);
+        if (unlocked) text += "  New character: " + QString(m_engine.koch().newestChar());
+        m_lblFeedback->setText(text);
+        
+        // Drop the scored text from the answer field so it stays short.
+        // Not from inside the textChanged handler that may have called us:
+        // the field is rewritten once that handler has returned.
+        if (m_entAnswer->text().length() - m_stream.pendingTyped() >= 40) {
+            QMetaObject::invokeMethod(this, &MainWindow::trimStreamAnswer, Qt::QueuedConnection);
+        }
+    }
+    
+    if (m_statsWindow && m_statsWindow->isVisible()) {
+        m_statsWindow->refreshData();
+    }
+}
+
+// Show the Koch lesson, its characters and the rolling window accuracy
+void MainWindow::updateKochStatus()
+{
+    QString text = QString("Lesson %1: %2").arg(m_engine.koch().lesson()).arg(m_engine.koch().activeChars());
+    if (m_engine.koch().windowCount() > 0) {
+        text += QString("  (%1% over last %2)").arg(qRound(m_engine.koch().windowAccuracy() * 100)).arg(m_engine.koch().windowCount());
+    }
+    m_lblKochStatus->setText(text);
+}
+
+// Remove the already scored start of the answer field (continuous copy)
+void MainWindow::trimStreamAnswer()
+{
+    if (!m_streamActive) return;
+    QString answer = m_entAnswer->text();
+    int scored = answer.length() - m_stream.pendingTyped();
+    if (scored < 40 || answer != m_answerShadow) return;
+    // Shadow and timestamps first, so the textChanged below is a no-op
+    m_answerShadow = answer.mid(scored);
+    m_keyTimes = m_keyTimes.mid(scored);
+    m_entAnswer->setText(m_answerShadow);
+}
+
+// Keep a timestamp for every character of the answer field
+// Characters up to the first difference keep their time; everything after it
+// is new (typed, pasted or decoded) and gets the current time
+void MainWindow::stampAnswer(const QString &text)
+{
+    int common = 0;
+    int limit = qMin(text.length(), m_answerShadow.length());
+    while (common < limit && text[common] == m_answerShadow[common]) ++common;
+    
+    m_keyTimes.resize(common);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (int i = common; i < text.length(); ++i) m_keyTimes.append(now);
+    
+    // Continuous copy: pass on the edit and score what has settled
+    if (m_streamActive && common < qMax(text.length(), m_answerShadow.length())) {
+        m_stream.removeTyped(m_answerShadow.length() - common);
+        m_stream.appendTyped(text.mid(common), now);
+        m_answerShadow = text;
+        commitStream(false);
+        return;
+    }
+    m_answerShadow = text;
+}
+
 // Send manual serial command from Dashboard
 void MainWindow::sendSerialCommand()
 {
@@ -764,7 +1165,7 @@ void MainWindow::sendSerialCommand()
 // Clear the Receive Log
 void MainWindow::clearRxLog()
 {
-    m_txtRx->clear();
+    m_rxLog->clear();
 }
 
 // Show/Hide Cheat Sheet
@@ -788,6 +1189,9 @@ void MainWindow::toggleCheatSheet()
 // Show/Hide Statistics Window
 void MainWindow::toggleStatistics()
 {
+    // The statistics window reads the live session of the engine
+    if (!m_engineReady) return;
+    
     // Lazy initialization
     if (!m_statsWindow) {
         m_statsWindow = new StatisticsWindow(m_tracker, this);
@@ -815,5 +1219,10 @@ void MainWindow::onAudioDeviceChanged(int index)
 {
     if (index < 0) return;
     QAudioDevice device = m_comboAudioDevice->itemData(index).value<QAudioDevice>();
+    if (device.isNull()) return;
     m_sound->setAudioDevice(device);
+    // Selected again at the next start (the name is shown until the list is opened)
+    QSettings settings;
+    settings.setValue("audio/device", device.id());
+    settings.setValue("audio/deviceName", device.description());
 }
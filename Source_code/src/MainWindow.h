@@ -6,6 +6,7 @@
 #include <QTabWidget>
 #include <QLabel>
 #include <QCloseEvent>
+#include <QShowEvent>
 #include <QPushButton>
 #include <QComboBox>
 #include <QSlider>
@@ -17,13 +18,18 @@
 #include <QSpinBox>
 #include <QCheckBox>
 #include <QGroupBox>
+#include <QElapsedTimer>
+#include <QThread>
 
 // Include Project Component Headers
 #include "SerialManager.h"
 #include "SoundGenerator.h"
 #include "CheatSheetWindow.h"
 #include "StatisticsWindow.h"
-#include "StatisticsTracker.h"
+#include "TrainerEngine.h"
+#include "StreamAligner.h"
+#include "RxLogModel.h"
+#include "RxLogView.h"
 
 // The MainWindow class is the central controller of the application.
 // It manages the UI, connects different components (Serial, Audio, Stats),
@@ -44,10 +50,12 @@ private slots:
     void refreshPorts();
     // Toggles the serial connection (Connect/Disconnect)
     void toggleConnection();
-    // Handles data received from the SerialManager
-    void onSerialLineReceived(QString line);
+    // Handles a device status line (dashboard updates, optional log echo)
+    void onSystemLineReceived(SerialManager::SystemMessage kind, QString value, QString line);
     // Handles raw text received from SerialManager (for immediate display)
     void onSerialTextReceived(QString text);
+    // Hands the device text collected since the last frame to the widgets
+    void flushSerialText();
     
     // --- Dashboard Slots ---
     // Sends the text from the TX text box to the serial port
@@ -76,14 +84,25 @@ private slots:
     void checkAnswer();
     // Sends the next character in the pending drill (for Online spacing)
     void sendNextDrillChar();
+    // Continuous copy: plays the next chunk of the stream
+    void playNextChunk();
 
     // Audio Slots
     void onVolumeChanged(int value);
     void onAudioDeviceChanged(int index);
 
+    // --- Startup Slots ---
+    // Background startup work is done: show what it found, enable drills
+    void onStartupLoaded();
+    // Lists the audio outputs (deferred until the device list is opened)
+    void populateAudioDevices();
+
 protected:
     // Event handler for window close event (used to save stats)
     void closeEvent(QCloseEvent *event) override;
+    // Startup timing: the first expose of the window marks the first frame
+    void showEvent(QShowEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
 
 private:
     // Internal helper to setup the User Interface widgets
@@ -95,8 +114,26 @@ private:
     // Internal helper to setup the Trainer tab
     void setupTrainer(QWidget *parent);
     
+    // The drill settings currently shown in the configuration card
+    DrillSettings drillSettings() const;
     // Helper to generate a random target string based on current settings
     QString generateTarget();
+    // Fills the port list and selects the port used last time
+    void fillPorts(const QStringList &ports);
+    // Logs the time since the constructor started
+    void logStartupPhase(const QString &phase);
+    // Shows the current Koch lesson in the configuration card
+    void updateKochStatus();
+    // Keeps one timestamp per answer character as the answer field changes
+    void stampAnswer(const QString &text);
+    // Records an attempt with the engine and shows the Koch progress
+    bool scoreAttempt(const QString &target, const QString &ans, const AttemptTiming &timing);
+    bool answerMatches(QString target, QString ans) const;
+    // Continuous copy stream control and scoring
+    void startContinuous();
+    void stopContinuous();
+    void commitStream(bool final);
+    void trimStreamAnswer();
 
     // --- UI Elements Pointers ---
     QTabWidget *m_tabs; // Main Tab Widget
@@ -112,18 +149,28 @@ private:
     QLabel *m_lblDashTone; // tone indicator
     QLabel *m_lblDashMode; // mode indicator
     QCheckBox *m_chkShowSys; // check to show system messages
-    QTextEdit *m_txtRx; // Received Text Display (ReadOnly)
+    RxLogModel *m_rxLog; // Received text (bounded line buffer)
+    RxLogView *m_rxView; // Received Text Display (ReadOnly, virtualized)
     QTextEdit *m_txtTx; // Transmit Text Input
     
     // Trainer Tab - Configuration Widgets
     QRadioButton *m_radioModeWords; // Option for 'Meaningful Words'
     QRadioButton *m_radioModeRandom; // Option for 'Random Characters'
+    QRadioButton *m_radioModeKoch; // Option for 'Koch Method' lessons
+    QRadioButton *m_radioModeQso; // Option for callsigns, contest exchanges and QSOs
+    QComboBox *m_comboQsoKind; // What the QSO mode generates
+    QRadioButton *m_radioModeText; // Option for generated plain-language text
+    QComboBox *m_comboTextLevel; // Letter or word level text model
+    QLabel *m_lblKochStatus; // Current Koch lesson and window accuracy
     QSpinBox *m_spinGroupSize; // Spinner for Random Group Length
     QSpinBox *m_spinSetSize; // Spinner for Set Size (number of groups) - *Unused in current logic*
     QRadioButton *m_radioRx; // Option for RX Drill (Listen & Type)
     QRadioButton *m_radioTx; // Option for TX Drill (Read & Key)
     QLineEdit *m_lineAllowedChars; // Input for allowed character set
     QCheckBox *m_chkIgnoreSpacing; // Checkbox to be lenient on spacing - *Unused logic placeholder*
+    QCheckBox *m_chkAdaptive; // Checkbox to weight random characters by error rate and latency
+    QCheckBox *m_chkReview; // Checkbox to mix due spaced-repetition reviews into drills
+    QCheckBox *m_chkContinuous; // Checkbox for continuous copy (endless RX stream)
     
     // Adjustable Spacing
     QCheckBox *m_chkAdjustableSpacing; // Checkbox for extra time spacing
@@ -152,14 +199,44 @@ private:
     SoundGenerator *m_sound; // Handles Audio Generation
     CheatSheetWindow *m_cheatSheet = nullptr; // Pointer to Cheat Sheet Window
     StatisticsWindow *m_statsWindow = nullptr; // Pointer to Stats Window
-    StatisticsTracker *m_tracker; // Handles Stats Logic
+    TrainerEngine m_engine; // Drill generation, scoring, stats, Koch and reviews
+    StatisticsTracker *m_tracker; // Session stats (owned by the engine)
     
     QString m_currentTarget; // Stores the current drill target string
 
+    // Recognition latency inputs for the current drill (ms since epoch)
+    QVector<qint64> m_cueEndMs;  // End of each target character's audio (RX)
+    qint64 m_targetShownMs = 0;  // When the target was shown (TX)
+    QVector<qint64> m_keyTimes;  // When each character of the answer field appeared
+    QString m_answerShadow;      // Answer text the timestamps belong to
+
     // For Device Spacing Control
     QTimer *m_drillTimer;
     QString m_pendingDrillText;
     int m_drillCharIdx;
+    
+    // Continuous copy
+    StreamAligner m_stream;      // Unscored part of the stream
+    bool m_streamActive = false;
+    int m_streamGroups = 0;      // Groups scored in this stream
+    int m_streamCorrect = 0;
+    QTimer *m_streamTimer;       // Periodic commit (scores groups left unanswered)
+    QTimer *m_streamChunkTimer;  // Device mode: when to send the next chunk
+
+    // Device text waiting for the next UI frame
+    QString m_pendingRx;
+    QTimer *m_rxFlushTimer;
+
+    // Startup: slow work runs on m_loader; its results are read once it finished
+    QElapsedTimer m_startupTimer;
+    QThread *m_loader = nullptr;
+    bool m_engineReady = false;  // Drills and statistics wait for the engine
+    bool m_firstPaintLogged = false;
+    bool m_audioDevicesListed = false; // The device combo still shows only the remembered one
+    QStringList m_loadedPorts;
+    qint64 m_loadPortsMs = 0;
+    qint64 m_loadEngineMs = 0;
+    qint64 m_loadStatsMs = 0;
 };
 
 #endif // MAINWINDOW_H
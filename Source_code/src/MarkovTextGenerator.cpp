@@ -0,0 +1,253 @@
+#include "MarkovTextGenerator.h"
+#include "CharIndex.h"
+#include <QFile>
+#include <QDir>
+#include <QHash>
+#include <algorithm>
+
+namespace {
+// Symbols: 0 is the word separator, CharIndex id + 1 for characters
+const int kSymbolBits = 6;
+// Consecutive dead ends before giving up on an allowed set
+const int kMaxRestarts = 50;
+
+inline QChar charFor(quint64 symbol) { return symbol == 0 ? QChar(' ') : CharIndex::charAt(int(symbol) - 1); }
+inline bool symbolAllowed(quint64 symbol, quint64 allowed) { return symbol == 0 || (allowed >> (symbol - 1)) & 1; }
+}
+
+// --- Table ---
+
+void MarkovTextGenerator::Table::build(QVector<quint64> &keys, int shift)
+{
+    clear();
+    std::sort(keys.begin(), keys.end());
+    const quint64 symbolMask = (quint64(1) << shift) - 1;
+    for (int i = 0; i < keys.size();) {
+        const quint64 key = keys[i];
+        int run = 1;
+        while (i + run < keys.size() && keys[i + run] == key) ++run;
+
+        const quint64 context = key >> shift;
+        if (contexts.isEmpty() || contexts.last() != context) {
+            contexts.append(context);
+            offsets.append(quint32(symbols.size()));
+        }
+        const bool first = offsets.last() == quint32(symbols.size());
+        symbols.append(quint32(key & symbolMask));
+        cumulative.append((first ? 0 : cumulative.last()) + quint32(run));
+        i += run;
+    }
+    offsets.append(quint32(symbols.size()));
+}
+
+int MarkovTextGenerator::Table::find(quint64 context) const
+{
+    auto it = std::lower_bound(contexts.cbegin(), contexts.cend(), context);
+    return (it != contexts.cend() && *it == context) ? int(it - contexts.cbegin()) : -1;
+}
+
+template <typename Allow>
+qint64 MarkovTextGenerator::Table::draw(int index, QRandomGenerator *rng, Allow allow) const
+{
+    if (index < 0) return -1;
+    const int begin = int(offsets[index]);
+    const int end = int(offsets[index + 1]);
+
+    // Unrestricted draw: binary search in the running counts
+    const quint32 total = cumulative[end - 1];
+    const quint32 r = quint32(rng->bounded(total));
+    const int j = int(std::upper_bound(cumulative.cbegin() + begin, cumulative.cbegin() + end, r) - cumulative.cbegin());
+    if (allow(symbols[j])) return symbols[j];
+
+    // Restricted: draw among the allowed symbols only
+    quint64 allowedTotal = 0;
+    for (int k = begin; k < end; ++k) {
+        if (allow(symbols[k])) allowedTotal += cumulative[k] - (k > begin ? cumulative[k - 1] : 0);
+    }
+    if (allowedTotal == 0) return -1;
+    quint64 pick = rng->bounded(allowedTotal);
+    for (int k = begin; k < end; ++k) {
+        if (!allow(symbols[k])) continue;
+        quint64 count = cumulative[k] - (k > begin ? cumulative[k - 1] : 0);
+        if (pick < count) return symbols[k];
+        pick -= count;
+    }
+    return -1;
+}
+
+void MarkovTextGenerator::Table::clear()
+{
+    contexts.clear();
+    offsets.clear();
+    symbols.clear();
+    cumulative.clear();
+}
+
+// --- MarkovTextGenerator ---
+
+MarkovTextGenerator::MarkovTextGenerator(int order)
+    : m_order(qBound(1, order, MaxOrder))
+{
+}
+
+void MarkovTextGenerator::train(const QString &text)
+{
+    // Append as symbols, collapsing every run of separators into one
+    m_text.reserve(m_text.size() + text.size() + 1);
+    if (m_text.isEmpty() || m_text.back() != 0) m_text.append(char(0));
+    for (QChar c : text) {
+        int id = CharIndex::id(c);
+        char symbol = id < CharIndex::Count ? char(id + 1) : char(0);
+        if (symbol == 0 && m_text.back() == 0) continue;
+        m_text.append(symbol);
+    }
+    m_dirty = true;
+}
+
+bool MarkovTextGenerator::trainFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    train(QString::fromUtf8(file.readAll()));
+    return true;
+}
+
+int MarkovTextGenerator::trainDirectory(const QString &dir)
+{
+    QDir d(dir);
+    int files = 0;
+    const QStringList names = d.entryList({"*.txt"}, QDir::Files, QDir::Name);
+    for (const QString &name : names) {
+        if (trainFile(d.filePath(name))) files++;
+    }
+    return files;
+}
+
+void MarkovTextGenerator::clear()
+{
+    m_text.clear();
+    m_chars.clear();
+    m_bigrams.clear();
+    m_unigrams.clear();
+    m_vocabulary.clear();
+    m_wordMasks.clear();
+    m_dirty = false;
+}
+
+void MarkovTextGenerator::ensureModel()
+{
+    if (!m_dirty) return;
+    m_dirty = false;
+
+    // Character model. Every word is also counted as if it followed nothing
+    // (context 0, then the word's own prefix), so context 0 doubles as the
+    // restart state after a dead end and the contexts reached from it exist.
+    const quint64 contextMask = (quint64(1) << (kSymbolBits * m_order)) - 1;
+    QVector<quint64> keys;
+    keys.reserve(m_text.size() * 2);
+    quint64 context = 0;     // Last m_order symbols
+    quint64 wordContext = 0; // Same, but reset at every separator
+    for (int i = 0; i < m_text.size(); ++i) {
+        const quint64 symbol = quint8(m_text[i]);
+        if (context != 0 || symbol != 0) keys.append(context << kSymbolBits | symbol);
+        if (wordContext != context && (wordContext != 0 || symbol != 0)) keys.append(wordContext << kSymbolBits | symbol);
+        context = ((context << kSymbolBits) | symbol) & contextMask;
+        wordContext = symbol == 0 ? 0 : (((wordContext << kSymbolBits) | symbol) & contextMask);
+    }
+    m_chars.build(keys, kSymbolBits);
+
+    // Word model: vocabulary, then bigrams over word ids
+    QVector<QByteArray> tokens;
+    for (const QByteArray &token : m_text.split(char(0))) {
+        if (!token.isEmpty()) tokens.append(token);
+    }
+    QVector<QByteArray> unique = tokens;
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+    QHash<QByteArray, quint32> ids;
+    m_vocabulary.clear();
+    m_wordMasks.clear();
+    for (const QByteArray &word : unique) {
+        ids.insert(word, quint32(m_vocabulary.size()));
+        QString text;
+        quint64 mask = 0;
+        for (char s : word) {
+            text.append(charFor(quint8(s)));
+            mask |= quint64(1) << (quint8(s) - 1);
+        }
+        m_vocabulary.append(text);
+        m_wordMasks.append(mask);
+    }
+
+    QVector<quint64> bigramKeys, unigramKeys;
+    bigramKeys.reserve(tokens.size());
+    unigramKeys.reserve(tokens.size());
+    for (int i = 0; i < tokens.size(); ++i) {
+        const quint64 id = ids.value(tokens[i]);
+        unigramKeys.append(id);
+        if (i > 0) bigramKeys.append(quint64(ids.value(tokens[i - 1])) << 32 | id);
+    }
+    m_bigrams.build(bigramKeys, 32);
+    m_unigrams.build(unigramKeys, 32);
+}
+
+QString MarkovTextGenerator::generate(Level level, int words, quint64 allowed, QRandomGenerator *rng)
+{
+    ensureModel();
+    if (m_text.isEmpty() || words <= 0) return QString();
+    return level == Level::Word ? generateWords(words, allowed, rng) : generateCharacters(words, allowed, rng);
+}
+
+QString MarkovTextGenerator::generateCharacters(int words, quint64 allowed, QRandomGenerator *rng)
+{
+    const quint64 contextMask = (quint64(1) << (kSymbolBits * m_order)) - 1;
+    auto allow = [allowed](quint64 symbol) { return symbolAllowed(symbol, allowed); };
+
+    QString out;
+    out.reserve(words * 6);
+    quint64 context = 0;
+    int wordStart = 0;
+    int done = 0;
+    int restarts = 0;
+    while (done < words) {
+        qint64 symbol = m_chars.draw(m_chars.find(context), rng, allow);
+        if (symbol < 0) {
+            // Dead end: drop the partial word and start a new one
+            out.truncate(wordStart);
+            if (context == 0 || ++restarts > kMaxRestarts) break;
+            context = 0;
+            continue;
+        }
+        if (symbol == 0) {
+            if (out.size() > wordStart) {
+                done++;
+                restarts = 0;
+                if (done < words) out.append(' ');
+                wordStart = out.size();
+            }
+        } else {
+            out.append(charFor(quint64(symbol)));
+        }
+        context = ((context << kSymbolBits) | quint64(symbol)) & contextMask;
+    }
+    // Dead ends already dropped any partial word
+    return out.trimmed();
+}
+
+QString MarkovTextGenerator::generateWords(int words, quint64 allowed, QRandomGenerator *rng)
+{
+    auto allow = [this, allowed](quint64 id) { return (m_wordMasks[int(id)] & ~allowed) == 0; };
+
+    QStringList out;
+    qint64 previous = -1;
+    for (int i = 0; i < words; ++i) {
+        qint64 next = previous < 0 ? -1 : m_bigrams.draw(m_bigrams.find(quint64(previous)), rng, allow);
+        // Back off to word frequencies when the bigram has no allowed follower
+        if (next < 0) next = m_unigrams.draw(m_unigrams.find(0), rng, allow);
+        if (next < 0) break;
+        out.append(m_vocabulary[int(next)]);
+        previous = next;
+    }
+    return out.join(' ');
+}
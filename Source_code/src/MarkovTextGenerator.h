@@ -0,0 +1,79 @@
+#ifndef MARKOVTEXTGENERATOR_H
+#define MARKOVTEXTGENERATOR_H
+
+// Include standard Qt classes for strings, containers and random numbers
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QByteArray>
+#include <QRandomGenerator>
+
+// Plain-language text for head-copy practice, generated by n-gram models
+// trained on the user's own texts.
+// Character level: order-k model over the Morse alphabet plus space.
+// Word level: bigram model over the corpus vocabulary, backing off to word
+// frequencies. Each model is a set of sorted flat arrays: unique contexts,
+// per-context offsets into the transition arrays, and for every context its
+// next symbols with running (cumulative) counts, so a draw is a binary search
+// for the context plus a binary search in its cumulative counts.
+// Draws can be restricted to an allowed character set (CharIndex mask, as in
+// WordCorpus); transitions to disallowed symbols are skipped.
+class MarkovTextGenerator
+{
+public:
+    enum class Level { Character, Word };
+
+    static constexpr int DefaultOrder = 4; // Characters of context
+    static constexpr int MaxOrder = 9;     // 6 bits per character in a 64-bit key
+
+    explicit MarkovTextGenerator(int order = DefaultOrder);
+
+    // Training text (any case; characters without a Morse code act as spaces)
+    void train(const QString &text);
+    bool trainFile(const QString &path);
+    // Every *.txt file of a directory; returns the number of files read
+    int trainDirectory(const QString &dir = defaultDirectory());
+    void clear();
+    bool isEmpty() const { return m_text.isEmpty(); }
+
+    // About `words` words of text using only allowed characters (empty if the
+    // model has nothing to offer for that set)
+    QString generate(Level level, int words, quint64 allowed = ~quint64(0),
+                     QRandomGenerator *rng = QRandomGenerator::global());
+
+    // Training texts are looked up next to the statistics
+    static QString defaultDirectory() { return QStringLiteral("texts"); }
+
+private:
+    // context -> {symbol, count} as sorted arrays with cumulative counts
+    struct Table {
+        QVector<quint64> contexts;   // Sorted, unique
+        QVector<quint32> offsets;    // contexts.size() + 1 entries into symbols/cumulative
+        QVector<quint32> symbols;
+        QVector<quint32> cumulative; // Running count within the context, inclusive
+
+        // Builds from keys = context << shift | symbol (sorted in place)
+        void build(QVector<quint64> &keys, int shift);
+        int find(quint64 context) const;
+        // Weighted draw among the context's symbols accepted by allow(); -1 if none
+        template <typename Allow>
+        qint64 draw(int index, QRandomGenerator *rng, Allow allow) const;
+        void clear();
+    };
+
+    void ensureModel();
+    QString generateCharacters(int words, quint64 allowed, QRandomGenerator *rng);
+    QString generateWords(int words, quint64 allowed, QRandomGenerator *rng);
+
+    int m_order;
+    QByteArray m_text;         // Normalized corpus: symbol per byte, single spaces
+    bool m_dirty = false;
+
+    Table m_chars;             // Order-k character model
+    QStringList m_vocabulary;  // Sorted unique words
+    QVector<quint64> m_wordMasks;
+    Table m_bigrams;           // Previous word id -> next word id
+    Table m_unigrams;          // Single context 0 -> word id (backoff)
+};
+
+#endif // MARKOVTEXTGENERATOR_H
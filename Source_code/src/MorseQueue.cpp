@@ -0,0 +1,81 @@
+#include "MorseQueue.h"
+#include <cstring>
+
+MorseQueue::MorseQueue(QObject *parent)
+    : QIODevice(parent)
+{
+}
+
+void MorseQueue::append(const QByteArray &pcm)
+{
+    if (pcm.isEmpty()) return;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_segments.enqueue(pcm);
+        m_queued += pcm.size();
+    }
+    emit readyRead();
+}
+
+void MorseQueue::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_segments.clear();
+    m_frontPos = 0;
+    m_queued = 0;
+}
+
+qint64 MorseQueue::trimTo(qint64 maxBytes)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_queued <= maxBytes || m_segments.size() < 2) return 0;
+
+    // The segment that is playing finishes; whole characters behind it go,
+    // so the sound never breaks off mid-tone
+    const QByteArray current = m_segments.dequeue();
+    qint64 dropped = 0;
+    while (!m_segments.isEmpty() && m_queued - dropped > maxBytes) {
+        dropped += m_segments.dequeue().size();
+    }
+    m_segments.prepend(current);
+    m_queued -= dropped;
+    return dropped;
+}
+
+qint64 MorseQueue::queuedBytes() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_queued;
+}
+
+qint64 MorseQueue::bytesAvailable() const
+{
+    return queuedBytes() + QIODevice::bytesAvailable();
+}
+
+qint64 MorseQueue::readData(char *data, qint64 maxSize)
+{
+    QMutexLocker lock(&m_mutex);
+    qint64 read = 0;
+    while (read < maxSize && !m_segments.isEmpty()) {
+        const QByteArray &front = m_segments.head();
+        qint64 take = qMin(maxSize - read, qint64(front.size()) - m_frontPos);
+        std::memcpy(data + read, front.constData() + m_frontPos, size_t(take));
+        read += take;
+        m_frontPos += take;
+        if (m_frontPos == front.size()) {
+            m_segments.dequeue();
+            m_frontPos = 0;
+        }
+    }
+    m_queued -= read;
+    return read;
+}
+
+qint64 MorseQueue::writeData(const char *data, qint64 maxSize)
+{
+    // Read-only device: segments come in through append()
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
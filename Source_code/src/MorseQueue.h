@@ -0,0 +1,44 @@
+#ifndef MORSEQUEUE_H
+#define MORSEQUEUE_H
+
+// Include QIODevice so the audio sink can pull from the queue
+#include <QIODevice>
+#include <QMutex>
+#include <QQueue>
+#include <QByteArray>
+
+// Ordered queue of PCM segments read by a QAudioSink in pull mode.
+// Text is appended one character (with its trailing gap) per segment while
+// the earlier ones play, so nothing is cut off and the spacing between
+// characters stays exact. When the queue runs dry, readData() returns 0 and
+// the sink goes idle until more arrives.
+class MorseQueue : public QIODevice
+{
+public:
+    explicit MorseQueue(QObject *parent = nullptr);
+
+    // Adds a segment behind everything queued
+    void append(const QByteArray &pcm);
+    // Drops everything not yet played
+    void clear();
+    // Catch-up: drops the oldest segments that have not started playing
+    // until at most maxBytes are left; returns the number of bytes dropped
+    qint64 trimTo(qint64 maxBytes);
+    // Bytes not yet played
+    qint64 queuedBytes() const;
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    mutable QMutex m_mutex;       // The sink may pull from its own thread
+    QQueue<QByteArray> m_segments;
+    qint64 m_frontPos = 0;        // Bytes of the front segment already played
+    qint64 m_queued = 0;          // Unplayed bytes over all segments
+};
+
+#endif // MORSEQUEUE_H
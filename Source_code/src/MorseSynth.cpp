@@ -0,0 +1,161 @@
+#include "MorseSynth.h"
+#include "MorseUtils.h"
+#include <qmath.h>
+
+// Generate the complete byte array of audio for the text
+QByteArray MorseSynth::generateAudioData(const QString &text, int wpm, int toneHz, int extraSpacingMs)
+{
+    QByteArray audio; // Buffer to accumulate audio data
+    
+    // Pre-generate sound chunks for efficiency
+    const Elements parts = elements(wpm, toneHz, extraSpacingMs);
+
+    // Get the character map from MorseUtils
+    auto morseMap = MorseUtils::getMorseMap();
+
+    // Loop through each character in the input text
+    for (int i = 0; i < text.length(); ++i) {
+        appendCharacter(audio, text[i], parts, morseMap);
+    }
+    
+    // Return the total generated audio data
+    return audio;
+}
+
+// Build the tone and gap chunks every character is made of
+MorseSynth::Elements MorseSynth::elements(int wpm, int toneHz, int extraSpacingMs)
+{
+    const int sampleRate = SampleRate;
+    // Calculate dot duration in seconds based on WPM (Paris standard: 50 dots = 1 word)
+    // Formula: 60 seconds / (50 * WPM) = 1.2 / WPM (at least 1 WPM)
+    double dotLen = 1.2 / double(qMax(1, wpm));
+
+    Elements parts;
+    parts.dot = createTone(dotLen, toneHz, sampleRate);
+    parts.dash = createTone(dotLen * 3, toneHz, sampleRate); // Dash is 3 dots
+    parts.elemGap = createSilence(dotLen, sampleRate); // Gap between parts of a char is 1 dot
+    // Standard spacing between characters is 3 dots; 1 'elemGap' already
+    // follows the last symbol, so 2 more dots of silence
+    parts.charGap = createSilence(dotLen * 2, sampleRate);
+    parts.wordGap = createSilence(dotLen * 7, sampleRate); // Gap between words is 7 dots
+
+    // Extra custom spacing
+    // Usually Farnsworth adds to characters, effectively slowing words too.
+    if (extraSpacingMs > 0) {
+        QByteArray customSpacing = createSilence(extraSpacingMs / 1000.0, sampleRate);
+        parts.charGap.append(customSpacing);
+        parts.wordGap.append(customSpacing);
+    }
+    return parts;
+}
+
+QByteArray MorseSynth::characterAudio(QChar c, const Elements &parts)
+{
+    QByteArray audio;
+    appendCharacter(audio, c, parts, MorseUtils::getMorseMap());
+    return audio;
+}
+
+void MorseSynth::appendCharacter(QByteArray &audio, QChar c, const Elements &parts, const QMap<QChar, QString> &morseMap)
+{
+    c = c.toUpper(); // Convert to uppercase
+
+    // Handle space (word separator)
+    if (c == ' ') {
+        audio.append(parts.wordGap);
+        return;
+    }
+
+    // Look up Morse code for character
+    QString code = morseMap.value(c);
+    // Skip unknown characters
+    if (code.isEmpty()) return;
+
+    // Loop through dots and dashes in the code
+    for (int j = 0; j < code.length(); ++j) {
+        if (code[j] == '.') audio.append(parts.dot);
+        else if (code[j] == '-') audio.append(parts.dash);
+
+        // Add gap after every symbol (dot or dash)
+        // Note: This adds a gap even after the last symbol of a character
+        audio.append(parts.elemGap);
+    }
+
+    // Add inter-character gap (with the custom extra spacing)
+    audio.append(parts.charGap);
+}
+
+// Compute the character timing of a text
+// Mirrors generateAudioData element by element, counting samples instead of
+// producing them, so the offsets match the generated audio exactly
+QVector<CharTiming> MorseSynth::schedule(const QString &text, int wpm, int extraSpacingMs, qint64 startMs)
+{
+    const int sampleRate = SampleRate;
+    const double dotLen = 1.2 / double(qMax(1, wpm)); // Same speed floor as elements()
+    auto samples = [sampleRate](double durationS) { return qint64(int(sampleRate * durationS)); };
+
+    const qint64 dot = samples(dotLen);
+    const qint64 dash = samples(dotLen * 3);
+    const qint64 elemGap = samples(dotLen);
+    const qint64 charGap = samples(dotLen * 2);
+    const qint64 wordGap = samples(dotLen * 7);
+    const qint64 custom = extraSpacingMs > 0 ? samples(extraSpacingMs / 1000.0) : 0;
+    auto toMs = [&](qint64 sampleOffset) { return startMs + sampleOffset * 1000 / sampleRate; };
+
+    auto morseMap = MorseUtils::getMorseMap();
+    QVector<CharTiming> timings(text.length());
+    qint64 pos = 0; // Samples from the start of playback
+    for (int i = 0; i < text.length(); ++i) {
+        QChar c = text[i].toUpper();
+        CharTiming &timing = timings[i];
+        timing.startMs = timing.endMs = toMs(pos);
+
+        if (c == ' ') {
+            pos += wordGap + custom;
+            continue;
+        }
+        QString code = morseMap.value(c);
+        if (code.isEmpty()) continue;
+
+        for (int j = 0; j < code.length(); ++j) {
+            if (code[j] == '.') pos += dot;
+            else if (code[j] == '-') pos += dash;
+            // The last tone ends before its trailing element gap
+            if (j == code.length() - 1) timing.endMs = toMs(pos);
+            pos += elemGap;
+        }
+        pos += charGap + custom;
+    }
+    return timings;
+}
+
+// Create a sine wave tone
+QByteArray MorseSynth::createTone(double durationS, int toneHz, int sampleRate)
+{
+    // Calculate total number of samples
+    int numSamples = int(sampleRate * durationS);
+    QByteArray chunk;
+    chunk.resize(numSamples * 2); // Resize buffer (2 bytes per sample for 16-bit)
+    
+    // Pointer to treat data as signed short (16-bit integer)
+    signed short *ptr = reinterpret_cast<signed short*>(chunk.data());
+    
+    // Generate samples
+    for (int i = 0; i < numSamples; ++i) {
+        // Current time 't'
+        double t = double(i) / sampleRate;
+        // Generate sine wave value, scale to 16-bit range
+        ptr[i] = static_cast<signed short>(32767.0 * qSin(2.0 * M_PI * toneHz * t));
+    }
+    return chunk;
+}
+
+// Create silence (zeros)
+QByteArray MorseSynth::createSilence(double durationS, int sampleRate)
+{
+    // Calculate total number of samples
+    int numSamples = int(sampleRate * durationS);
+    // Create a byte array of zeros
+    QByteArray chunk(numSamples * 2, 0); // 2 bytes per sample, initialized to 0
+    return chunk;
+}
@@ -0,0 +1,59 @@
+#ifndef MORSESYNTH_H
+#define MORSESYNTH_H
+
+// Include standard Qt classes for strings and containers
+#include <QString>
+#include <QByteArray>
+#include <QMap>
+#include <QVector>
+
+// Audio timing of one character of a played text (ms since epoch)
+struct CharTiming {
+    qint64 startMs = 0; // First tone of the character
+    qint64 endMs = 0;   // End of its last tone (spaces and unknown characters: start == end)
+};
+
+// Morse audio as raw PCM (44.1 kHz, 16-bit mono) and its timing.
+// Needs no audio device or Qt Multimedia, so the engine, the command line
+// and the benchmarks can render to memory or to a file; SoundGenerator plays
+// what it produces.
+class MorseSynth
+{
+public:
+    static constexpr int SampleRate = 44100;
+
+    // Raw audio of the entire text, as played.
+    // extraSpacingMs: Additional silence between characters (Farnsworth spacing)
+    static QByteArray generateAudioData(const QString &text, int wpm, int toneHz, int extraSpacingMs);
+
+    // PCM of the Morse elements at one speed, tone and spacing. Built once,
+    // they can render any number of characters without new synthesis.
+    struct Elements {
+        QByteArray dot;     // One dot of tone
+        QByteArray dash;    // Three dots of tone
+        QByteArray elemGap; // One dot of silence, after every tone
+        QByteArray charGap; // Two more dots after a character, plus the extra spacing
+        QByteArray wordGap; // Seven dots, plus the extra spacing
+    };
+    static Elements elements(int wpm, int toneHz, int extraSpacingMs);
+
+    // Audio of one character with its trailing gap, as generateAudioData
+    // renders it (empty for characters without a code)
+    static QByteArray characterAudio(QChar c, const Elements &parts);
+
+    // When each character of text is heard if playback starts at startMs.
+    // Uses exactly the element lengths of generateAudioData, so it can also
+    // estimate the timing of text played by an external device.
+    static QVector<CharTiming> schedule(const QString &text, int wpm, int extraSpacingMs, qint64 startMs);
+
+    // Helper method to create a sine wave tone for a specific duration and frequency
+    static QByteArray createTone(double durationS, int toneHz, int sampleRate);
+
+    // Helper method to create silence (for spacing) for a specific duration
+    static QByteArray createSilence(double durationS, int sampleRate);
+
+private:
+    static void appendCharacter(QByteArray &audio, QChar c, const Elements &parts, const QMap<QChar, QString> &morseMap);
+};
+
+#endif // MORSESYNTH_H
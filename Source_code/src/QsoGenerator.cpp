@@ -0,0 +1,212 @@
+#include "QsoGenerator.h"
+#include <QHash>
+#include <iterator>
+
+namespace {
+// Prefixes with rough on-air frequencies (weights are relative).
+// A prefix that already contains the call area digit has no digit list.
+struct PrefixInfo {
+    const char *prefix;
+    const char *digits;
+    double weight;
+};
+const PrefixInfo kPrefixes[] = {
+    {"K", "0123456789", 10}, {"W", "0123456789", 10}, {"N", "0123456789", 6},
+    {"AA", "0123456789", 1}, {"AB", "0123456789", 1}, {"AC", "0123456789", 1}, {"AD", "0123456789", 1},
+    {"KB", "0123456789", 1}, {"KD", "0123456789", 1}, {"WA", "0123456789", 1}, {"WB", "0123456789", 1},
+    {"VE", "1234567", 3}, {"VA", "1234567", 1},
+    {"G", "034", 4}, {"M", "0156", 3}, {"GM", "034", 1}, {"GW", "04", 1}, {"EI", "2345789", 1},
+    {"DL", "1234567890", 8}, {"DK", "1234567890", 2}, {"DJ", "1234567890", 1}, {"DO", "1234567", 1},
+    {"F", "12345689", 4}, {"ON", "4567", 2}, {"PA", "0123", 2}, {"PD", "0123", 1}, {"OE", "135679", 1},
+    {"HB9", "", 2}, {"I", "12345678", 3}, {"IK", "1234568", 2}, {"IZ", "12345678", 1},
+    {"EA", "12345789", 4}, {"CT", "1237", 1}, {"OH", "1234567890", 2}, {"SM", "01234567", 2},
+    {"LA", "1234", 1}, {"OZ", "1", 1}, {"OK", "12", 3}, {"OM", "2345", 1}, {"SP", "1234567", 4},
+    {"HA", "15", 2}, {"YO", "2345789", 1}, {"LZ", "12", 1}, {"S5", "", 1}, {"9A", "", 2},
+    {"YU", "1", 1}, {"UA", "13469", 4}, {"RA", "3", 2}, {"UR", "5", 2}, {"LY", "2", 1}, {"YL", "2", 1},
+    {"ES", "1", 1}, {"4X", "", 1}, {"JA", "1234567890", 5}, {"JH", "1234", 1}, {"HL", "1245", 1},
+    {"BY", "14", 1}, {"VK", "234567", 2}, {"ZL", "1234", 1}, {"PY", "1234", 2}, {"LU", "1234", 1},
+    {"CE", "3", 1}, {"XE", "12", 1}, {"ZS", "16", 1}, {"KH6", "", 1}, {"KL7", "", 1}
+};
+// Suffix length 1, 2 or 3 letters
+const double kSuffixLengthWeights[] = {0.08, 0.37, 0.55};
+// Share of calls that are portable/mobile operations
+const double kPortableShare = 0.04;
+
+// Signal reports, mostly the "5NN" everyone sends in contests
+struct RstInfo {
+    const char *rst;
+    double weight;
+};
+const RstInfo kRsts[] = {{"5NN", 12}, {"599", 6}, {"579", 2}, {"589", 2}, {"569", 1}, {"559", 1}, {"449", 0.5}};
+// Share of exchanges sent with cut numbers
+const double kCutShare = 0.5;
+
+const QStringList kNames = {"JOHN", "BOB", "TOM", "JIM", "MIKE", "BILL", "DAVE", "HANS", "PETER", "KLAUS",
+                            "JEAN", "LUC", "MARCO", "PAOLO", "JOSE", "ANA", "MARIA", "YURI", "IVAN", "KEN",
+                            "TARO", "ANDY", "CHRIS", "STEVE", "PAUL", "ROB", "FRED", "JAN", "ERIK", "LARS"};
+const QStringList kQths = {"BOSTON", "DENVER", "AUSTIN", "SEATTLE", "TORONTO", "LONDON", "DUBLIN", "BERLIN",
+                           "MUNICH", "PARIS", "LYON", "ROME", "MILAN", "MADRID", "LISBON", "VIENNA",
+                           "PRAGUE", "WARSAW", "OSLO", "HELSINKI", "MOSCOW", "KYIV", "TOKYO", "OSAKA",
+                           "SYDNEY", "AUCKLAND", "RIO", "SANTIAGO", "ZURICH", "AMSTERDAM"};
+const QStringList kRigs = {"IC7300", "IC7610", "FT991", "FTDX10", "FT817", "K3", "K4", "KX2", "TS590",
+                           "TS480", "HOMEBREW", "QRP KIT"};
+const QStringList kPowers = {"5", "10", "50", "100", "100", "100", "400", "500"};
+const QStringList kAntennas = {"DIPOLE", "VERTICAL", "YAGI", "EFHW", "LOOP", "WIRE", "HEX BEAM", "GP"};
+const QStringList kWeather = {"SUNNY", "CLOUDY", "RAIN", "SNOW", "FOG", "WINDY", "FB", "HOT", "COLD"};
+
+// One over per entry; fields are in braces, "=" is the BT separator
+const char *const kRagchew[] = {
+    "CQ CQ CQ DE {CALL} {CALL} {CALL} K",
+    "{OTHER} DE {CALL} GM ES TNX FER CALL = UR RST {RST} {RST} = NAME {NAME} {NAME} = QTH {QTH} {QTH} = HW? {OTHER} DE {CALL} K",
+    "{OTHER} DE {CALL} R FB OM TNX FER RPT = RIG {RIG} PWR {PWR}W ANT {ANT} = WX {WX} TEMP {TEMP}C = {OTHER} DE {CALL} K",
+    "{OTHER} DE {CALL} R R TNX {NAME} = UR SIG {RST} HR IN {QTH} = OP HR IS {NAME} = BK",
+    "{OTHER} DE {CALL} TNX FER NICE QSO {NAME} = HPE CUAGN = 73 ES GL {OTHER} DE {CALL} SK",
+    "{OTHER} DE {CALL} QSL VIA BURO = 73 TU {CALL} SK"
+};
+}
+
+QsoGenerator::QsoGenerator()
+{
+    QVector<double> weights;
+    for (const PrefixInfo &p : kPrefixes) {
+        m_prefixes.append({QString::fromLatin1(p.prefix), QString::fromLatin1(p.digits)});
+        weights.append(p.weight);
+    }
+    m_prefixTable.build(weights);
+
+    m_suffixLengthTable.build(QVector<double>(std::begin(kSuffixLengthWeights), std::end(kSuffixLengthWeights)));
+
+    weights.clear();
+    for (const RstInfo &r : kRsts) {
+        m_rsts.append(QString::fromLatin1(r.rst));
+        weights.append(r.weight);
+    }
+    m_rstTable.build(weights);
+
+    // Serial numbers 001..999, plain and with cut numbers
+    for (int n = 1; n <= 999; ++n) {
+        QString s = QString("%1").arg(n, 3, 10, QChar('0'));
+        m_serials.append(s);
+        s.replace('0', 'T').replace('9', 'N');
+        m_cutSerials.append(s);
+    }
+    for (int z = 1; z <= 40; ++z) m_zones.append(QString::number(z));
+
+    for (const char *text : kRagchew) m_ragchew.append(parseTemplate(QString::fromLatin1(text)));
+}
+
+const QString &QsoGenerator::pick(const QStringList &list, QRandomGenerator *rng)
+{
+    return list[int(rng->bounded(quint32(list.size())))];
+}
+
+QVector<QsoGenerator::Token> QsoGenerator::parseTemplate(const QString &text)
+{
+    static const QHash<QString, Field> fields = {
+        {"CALL", Call}, {"OTHER", OtherCall}, {"RST", Rst}, {"SERIAL", Serial}, {"ZONE", Zone},
+        {"NAME", Name}, {"QTH", Qth}, {"RIG", Rig}, {"PWR", Power}, {"ANT", Antenna},
+        {"WX", Weather}, {"TEMP", Temperature}
+    };
+    QVector<Token> tokens;
+    int pos = 0;
+    while (pos < text.size()) {
+        int open = text.indexOf('{', pos);
+        int close = open < 0 ? -1 : text.indexOf('}', open);
+        if (close < 0) {
+            tokens.append({Literal, text.mid(pos)});
+            break;
+        }
+        if (open > pos) tokens.append({Literal, text.mid(pos, open - pos)});
+        tokens.append({fields.value(text.mid(open + 1, close - open - 1), Literal), QString()});
+        pos = close + 1;
+    }
+    return tokens;
+}
+
+void QsoGenerator::appendCallsign(QString &out, QRandomGenerator *rng) const
+{
+    const Prefix &prefix = m_prefixes[m_prefixTable.sample(*rng)];
+    out += prefix.text;
+    if (!prefix.digits.isEmpty()) out += prefix.digits[int(rng->bounded(quint32(prefix.digits.size())))];
+    int letters = 1 + m_suffixLengthTable.sample(*rng);
+    for (int i = 0; i < letters; ++i) out += QChar('A' + int(rng->bounded(26)));
+
+    if (rng->generateDouble() < kPortableShare) {
+        static const char *const kPortable[] = {"/P", "/P", "/M", "/QRP"};
+        out += QLatin1String(kPortable[rng->bounded(4)]);
+    }
+}
+
+void QsoGenerator::appendTemplate(QString &out, const QVector<Token> &tokens, QRandomGenerator *rng) const
+{
+    // A field repeated within an over (calls, "NAME BOB BOB") keeps its value
+    QString values[FieldCount];
+    for (const Token &t : tokens) {
+        if (t.field == Literal) {
+            out += t.text;
+            continue;
+        }
+        QString &value = values[t.field];
+        if (value.isEmpty()) {
+            switch (t.field) {
+            case Literal: break;
+            case Call:
+            case OtherCall: appendCallsign(value, rng); break;
+            case Rst: value = m_rsts[m_rstTable.sample(*rng)]; break;
+            case Serial: value = pick(rng->generateDouble() < kCutShare ? m_cutSerials : m_serials, rng); break;
+            case Zone: value = pick(m_zones, rng); break;
+            case Name: value = pick(kNames, rng); break;
+            case Qth: value = pick(kQths, rng); break;
+            case Rig: value = pick(kRigs, rng); break;
+            case Power: value = pick(kPowers, rng); break;
+            case Antenna: value = pick(kAntennas, rng); break;
+            case Weather: value = pick(kWeather, rng); break;
+            case Temperature: value = QString::number(int(rng->bounded(-10, 36))); break;
+            case FieldCount: break;
+            }
+        }
+        out += value;
+    }
+}
+
+QString QsoGenerator::callsign(QRandomGenerator *rng) const
+{
+    QString out;
+    out.reserve(12);
+    appendCallsign(out, rng);
+    return out;
+}
+
+QString QsoGenerator::generate(QsoKind kind, QRandomGenerator *rng) const
+{
+    QString out;
+    switch (kind) {
+    case QsoKind::Callsign:
+        out.reserve(12);
+        appendCallsign(out, rng);
+        break;
+    case QsoKind::SerialExchange:
+    case QsoKind::ZoneExchange:
+        out.reserve(24);
+        appendCallsign(out, rng);
+        out += ' ';
+        out += m_rsts[m_rstTable.sample(*rng)];
+        out += ' ';
+        if (kind == QsoKind::ZoneExchange) out += pick(m_zones, rng);
+        else out += pick(rng->generateDouble() < kCutShare ? m_cutSerials : m_serials, rng);
+        break;
+    case QsoKind::Ragchew:
+        out.reserve(160);
+        appendTemplate(out, m_ragchew[int(rng->bounded(quint32(m_ragchew.size())))], rng);
+        break;
+    }
+    return out;
+}
+
+QStringList QsoGenerator::generate(QsoKind kind, int count, QRandomGenerator *rng) const
+{
+    QStringList items;
+    items.reserve(count);
+    for (int i = 0; i < count; ++i) items.append(generate(kind, rng));
+    return items;
+}
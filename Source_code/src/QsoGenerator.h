@@ -0,0 +1,63 @@
+#ifndef QSOGENERATOR_H
+#define QSOGENERATOR_H
+
+// Include standard Qt classes for strings, containers and random numbers
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QRandomGenerator>
+#include "AliasTable.h"
+
+// Kinds of on-air text the generator produces
+enum class QsoKind {
+    Callsign,        // "DL3ABC", "K1XY/P"
+    SerialExchange,  // Call, RST and serial number: "G4ABC 5NN 1T7"
+    ZoneExchange,    // Call, RST and CQ zone: "JA1XYZ 5NN 25"
+    Ragchew          // One over of a conversational QSO
+};
+
+// Realistic callsigns, contest exchanges and ragchew QSO overs.
+// Everything that can be is computed once in the constructor: prefixes and
+// their frequencies go into an alias table, serial numbers and zones (plain
+// and with cut numbers) into string tables, and the QSO templates are parsed
+// into literal/field tokens. Generating an item is then a handful of O(1)
+// table draws and appends into a preallocated string.
+class QsoGenerator
+{
+public:
+    QsoGenerator();
+
+    QString callsign(QRandomGenerator *rng = QRandomGenerator::global()) const;
+    QString generate(QsoKind kind, QRandomGenerator *rng = QRandomGenerator::global()) const;
+    // count items at once (for long sessions and batch rendering)
+    QStringList generate(QsoKind kind, int count, QRandomGenerator *rng = QRandomGenerator::global()) const;
+
+private:
+    // Template fields
+    enum Field { Literal, Call, OtherCall, Rst, Serial, Zone, Name, Qth, Rig, Power, Antenna, Weather, Temperature, FieldCount };
+    struct Token {
+        Field field;
+        QString text; // For Literal
+    };
+    struct Prefix {
+        QString text;
+        QString digits; // Call area digits to pick from (empty if the prefix has one)
+    };
+
+    void appendCallsign(QString &out, QRandomGenerator *rng) const;
+    void appendTemplate(QString &out, const QVector<Token> &tokens, QRandomGenerator *rng) const;
+    static QVector<Token> parseTemplate(const QString &text);
+    static const QString &pick(const QStringList &list, QRandomGenerator *rng);
+
+    QVector<Prefix> m_prefixes;
+    AliasTable m_prefixTable;
+    AliasTable m_suffixLengthTable; // 1..3 letters
+    AliasTable m_rstTable;
+    QStringList m_rsts;
+    QStringList m_serials;     // 1..999, zero-padded
+    QStringList m_cutSerials;  // Same with cut numbers (0 -> T, 9 -> N)
+    QStringList m_zones;       // CQ zones 1..40
+    QVector<QVector<Token>> m_ragchew;
+};
+
+#endif // QSOGENERATOR_H
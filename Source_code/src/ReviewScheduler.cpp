@@ -0,0 +1,275 @@
+#include "ReviewScheduler.h"
+#include "EditAligner.h"
+#include <QHash>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+#include <utility>
+
+namespace {
+const qint64 kDayMs = 24LL * 60 * 60 * 1000;
+// A failed card comes back within the same session
+const qint64 kRelearnMs = 10LL * 60 * 1000;
+// Bounds that keep a well-known card from drifting out of reach
+const double kMaxEasiness = 3.0;
+const double kMaxIntervalDays = 365;
+
+// Review cache file
+const quint32 kCacheMagic = 0x43525743; // "CWRC"
+const quint32 kCacheVersion = 1;
+// Archive bytes just before the replayed offset, kept to notice a replaced archive
+const qint64 kTailBytes = 16;
+
+QByteArray archiveTail(const QString &archivePath, qint64 offset)
+{
+    QFile file(archivePath);
+    if (offset <= 0 || !file.open(QIODevice::ReadOnly) || offset > file.size()) return QByteArray();
+    const qint64 from = qMax(qint64(0), offset - kTailBytes);
+    if (!file.seek(from)) return QByteArray();
+    return file.read(offset - from);
+}
+}
+
+// --- ReviewScheduler ---
+
+int ReviewScheduler::grade(const QString &target, const QString &answer)
+{
+    Alignment alignment = EditAligner::align(target, answer);
+    if (alignment.distance == 0) return 5;
+    // One slip in a longer item still counts as recalled, with difficulty
+    if (alignment.distance == 1) return target.length() >= 4 ? 3 : 2;
+    return alignment.distance < target.length() ? 1 : 0;
+}
+
+void ReviewScheduler::review(const QString &key, int quality, qint64 nowMs)
+{
+    int &slot = m_index[key];
+    if (slot == 0) {
+        // FlatHashMap default-constructs 0, so indices are stored +1
+        ReviewCard fresh;
+        fresh.key = key;
+        m_cards.append(fresh);
+        m_heap.append(m_cards.size() - 1);
+        m_heapPos.append(m_heap.size() - 1);
+        slot = m_cards.size();
+    }
+    const int index = slot - 1;
+    ReviewCard &card = m_cards[index];
+
+    quality = qBound(0, quality, 5);
+    // Seen again before it is due (characters come up in every group): a
+    // recall says nothing new, only a failure reschedules the card
+    if (quality >= 3 && nowMs < card.dueMs) return;
+
+    if (quality >= 3) {
+        if (card.repetitions == 0) card.intervalDays = 1;
+        else if (card.repetitions == 1) card.intervalDays = 6;
+        else card.intervalDays = qMin(card.intervalDays * card.easiness, kMaxIntervalDays);
+        card.repetitions++;
+        card.dueMs = nowMs + qint64(card.intervalDays * kDayMs);
+    } else {
+        card.repetitions = 0;
+        card.intervalDays = 0;
+        card.lapses++;
+        card.dueMs = nowMs + kRelearnMs;
+    }
+    int miss = 5 - quality;
+    card.easiness = qBound(1.3, card.easiness + (0.1 - miss * (0.08 + miss * 0.02)), kMaxEasiness);
+
+    // Restore the heap order around the moved (or new) card; one of the two is a no-op
+    siftUp(m_heapPos[index]);
+    siftDown(m_heapPos[index]);
+}
+
+QStringList ReviewScheduler::due(int max, qint64 nowMs, const std::function<bool(const QString &)> &accept) const
+{
+    QStringList result;
+    if (m_heap.isEmpty() || max <= 0) return result;
+
+    // Best-first walk of the heap: a small frontier heap of heap positions,
+    // so only cards that are actually inspected cost anything
+    auto later = [this](int a, int b) { return m_cards[m_heap[a]].dueMs > m_cards[m_heap[b]].dueMs; };
+    QVector<int> frontier;
+    frontier.append(0);
+    while (!frontier.isEmpty() && result.size() < max) {
+        std::pop_heap(frontier.begin(), frontier.end(), later);
+        int pos = frontier.takeLast();
+        const ReviewCard &card = m_cards[m_heap[pos]];
+        if (card.dueMs > nowMs) break; // Everything else is due later
+
+        if (accept(card.key)) result.append(card.key);
+        for (int child : {2 * pos + 1, 2 * pos + 2}) {
+            if (child < m_heap.size()) {
+                frontier.append(child);
+                std::push_heap(frontier.begin(), frontier.end(), later);
+            }
+        }
+    }
+    return result;
+}
+
+const ReviewCard *ReviewScheduler::card(const QString &key) const
+{
+    const int *slot = m_index.find(key);
+    return slot ? &m_cards[*slot - 1] : nullptr;
+}
+
+void ReviewScheduler::clear()
+{
+    m_cards.clear();
+    m_index.clear();
+    m_heap.clear();
+    m_heapPos.clear();
+}
+
+void ReviewScheduler::write(QDataStream &out) const
+{
+    out << qint32(m_cards.size());
+    for (const ReviewCard &card : m_cards) {
+        out << card.key << card.easiness << qint32(card.repetitions) << card.intervalDays
+            << qint32(card.lapses) << card.dueMs;
+    }
+}
+
+bool ReviewScheduler::read(QDataStream &in)
+{
+    clear();
+    qint32 count = 0;
+    in >> count;
+    if (count < 0 || in.status() != QDataStream::Ok) return false;
+    m_cards.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        ReviewCard card;
+        qint32 repetitions = 0, lapses = 0;
+        in >> card.key >> card.easiness >> repetitions >> card.intervalDays >> lapses >> card.dueMs;
+        card.repetitions = repetitions;
+        card.lapses = lapses;
+        int &slot = m_index[card.key];
+        if (slot != 0) break; // Duplicate key: not a file we wrote
+        m_cards.append(card);
+        slot = m_cards.size();
+    }
+    if (in.status() != QDataStream::Ok || m_cards.size() != count) {
+        clear();
+        return false;
+    }
+
+    // Heapify in place: O(n)
+    m_heap.resize(count);
+    m_heapPos.resize(count);
+    for (int i = 0; i < count; ++i) m_heap[i] = m_heapPos[i] = i;
+    for (int pos = count / 2 - 1; pos >= 0; --pos) siftDown(pos);
+    return true;
+}
+
+void ReviewScheduler::swapNodes(int a, int b)
+{
+    std::swap(m_heap[a], m_heap[b]);
+    m_heapPos[m_heap[a]] = a;
+    m_heapPos[m_heap[b]] = b;
+}
+
+void ReviewScheduler::siftUp(int pos)
+{
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!before(pos, parent)) break;
+        swapNodes(pos, parent);
+        pos = parent;
+    }
+}
+
+void ReviewScheduler::siftDown(int pos)
+{
+    const int n = m_heap.size();
+    while (true) {
+        int smallest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < n && before(left, smallest)) smallest = left;
+        if (right < n && before(right, smallest)) smallest = right;
+        if (smallest == pos) break;
+        swapNodes(pos, smallest);
+        pos = smallest;
+    }
+}
+
+// --- ReviewDeck ---
+
+void ReviewDeck::recordAttempt(const QString &target, const QString &answer, qint64 nowMs)
+{
+    QString t = target.trimmed().toUpper();
+    QString u = answer.trimmed().toUpper();
+    if (t.isEmpty()) return;
+
+    // Only items that can be drawn again are worth a card
+    if (!m_itemFilter || m_itemFilter(t)) m_items.review(t, ReviewScheduler::grade(t, u), nowMs);
+
+    // Worst result per distinct character of this attempt
+    QHash<QChar, int> quality;
+    Alignment alignment = EditAligner::align(t, u);
+    for (const AlignedPair &step : alignment.steps) {
+        if (step.op == EditOp::Insert || step.target == ' ') continue;
+        int q = step.op == EditOp::Match ? 5 : (step.op == EditOp::Substitute ? 1 : 0);
+        auto it = quality.find(step.target);
+        if (it == quality.end()) quality.insert(step.target, q);
+        else *it = qMin(*it, q);
+    }
+    for (auto it = quality.cbegin(); it != quality.cend(); ++it) {
+        m_chars.review(QString(it.key()), it.value(), nowMs);
+    }
+}
+
+int ReviewDeck::loadHistory(const QString &archivePath, const QString &cachePath, bool writeCache)
+{
+    // Start from the cached cards, or from nothing
+    qint64 offset = 0;
+    if (!loadCache(cachePath, archivePath, offset)) {
+        m_items.clear();
+        m_chars.clear();
+        offset = 0;
+    }
+
+    int replayed = 0;
+    qint64 validBytes = 0;
+    const QVector<JournalRecord> records = AttemptJournal::read(archivePath, &validBytes, offset);
+    for (const JournalRecord &r : records) {
+        if (r.type != JournalRecordType::Attempt) continue;
+        recordAttempt(r.target, r.user, r.timestampMs);
+        replayed++;
+    }
+    if (writeCache && validBytes > offset) saveCache(cachePath, archivePath, validBytes);
+    return replayed;
+}
+
+bool ReviewDeck::loadCache(const QString &cachePath, const QString &archivePath, qint64 &offset)
+{
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setByteOrder(QDataStream::LittleEndian);
+    quint32 magic = 0, version = 0;
+    QByteArray tail;
+    in >> magic >> version;
+    if (magic != kCacheMagic || version != kCacheVersion) return false;
+    in >> offset >> tail;
+    // The archive must still hold exactly what the cards were built from
+    if (in.status() != QDataStream::Ok || tail.isEmpty() || archiveTail(archivePath, offset) != tail) return false;
+    return m_items.read(in) && m_chars.read(in);
+}
+
+bool ReviewDeck::saveCache(const QString &cachePath, const QString &archivePath, qint64 offset) const
+{
+    const QByteArray tail = archiveTail(archivePath, offset);
+    if (tail.isEmpty()) return false;
+
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << kCacheMagic << kCacheVersion << offset << tail;
+    m_items.write(out);
+    m_chars.write(out);
+    return file.commit();
+}
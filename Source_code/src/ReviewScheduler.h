@@ -0,0 +1,100 @@
+#ifndef REVIEWSCHEDULER_H
+#define REVIEWSCHEDULER_H
+
+// Include standard Qt classes for strings and containers
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QDataStream>
+#include <functional>
+#include <utility>
+#include "FlatHashMap.h"
+#include "AttemptJournal.h"
+
+// Review state of one character or item (SM-2)
+struct ReviewCard {
+    QString key;
+    double easiness = 2.5;    // SM-2 E-factor, 1.3 to 3.0
+    int repetitions = 0;      // Successful reviews in a row
+    double intervalDays = 0;  // Interval that produced dueMs (at most a year)
+    int lapses = 0;           // Failed reviews
+    qint64 dueMs = 0;         // Next review (ms since epoch)
+};
+
+// SM-2 spaced-repetition scheduler.
+// Cards live in a flat array indexed through a FlatHashMap; an indexed binary
+// min-heap orders them by due time, so reviewing a card (which moves its due
+// time) and finding the next due card are O(log n) and O(1).
+class ReviewScheduler
+{
+public:
+    // SM-2 quality (0..5) of an answer to a target
+    static int grade(const QString &target, const QString &answer);
+
+    // Applies one review of key (created on first review) at nowMs.
+    // A correct answer before the card is due leaves it unchanged.
+    void review(const QString &key, int quality, qint64 nowMs);
+
+    // Up to max keys due at nowMs for which accept() holds, most overdue first.
+    // Cost is O(k log n) for the k cards inspected.
+    QStringList due(int max, qint64 nowMs, const std::function<bool(const QString &)> &accept) const;
+
+    // Earliest due time (or -1 if there are no cards)
+    qint64 nextDueMs() const { return m_heap.isEmpty() ? -1 : m_cards[m_heap[0]].dueMs; }
+
+    const ReviewCard *card(const QString &key) const;
+    int size() const { return m_cards.size(); }
+    void clear();
+
+    // Serialization of the card table (the heap is rebuilt on read)
+    void write(QDataStream &out) const;
+    bool read(QDataStream &in);
+
+private:
+    bool before(int a, int b) const { return m_cards[m_heap[a]].dueMs < m_cards[m_heap[b]].dueMs; }
+    void swapNodes(int a, int b);
+    void siftUp(int pos);
+    void siftDown(int pos);
+
+    QVector<ReviewCard> m_cards;
+    FlatHashMap<int> m_index; // Key -> card index
+    QVector<int> m_heap;      // Card indices, min-heap on dueMs
+    QVector<int> m_heapPos;   // Card index -> heap position
+};
+
+// Character and item schedulers fed from the same attempts.
+// Items are the normalized targets that pass the item filter (e.g. corpus
+// words); characters are graded per attempt with the worst result of each
+// distinct character.
+class ReviewDeck
+{
+public:
+    // Which targets get an item card (all if unset). Random groups are never
+    // drawn again, so scheduling them only fills the heap.
+    void setItemFilter(std::function<bool(const QString &)> filter) { m_itemFilter = std::move(filter); }
+
+    void recordAttempt(const QString &target, const QString &answer, qint64 nowMs);
+
+    // Brings both schedulers up to date with the attempt archive (oldest
+    // first). The cards and the archive offset they cover are kept in
+    // cachePath, so only attempts appended since are replayed; a missing or
+    // stale cache (archive replaced or cut back) means a full replay.
+    // writeCache: write the cache back if anything was replayed.
+    // Returns the number of attempts replayed.
+    int loadHistory(const QString &archivePath = AttemptJournal::archiveFile(),
+                    const QString &cachePath = cacheFile(), bool writeCache = true);
+    static QString cacheFile() { return QStringLiteral("review_cards.dat"); }
+
+    ReviewScheduler &items() { return m_items; }
+    ReviewScheduler &characters() { return m_chars; }
+
+private:
+    bool loadCache(const QString &cachePath, const QString &archivePath, qint64 &offset);
+    bool saveCache(const QString &cachePath, const QString &archivePath, qint64 offset) const;
+
+    ReviewScheduler m_items;
+    ReviewScheduler m_chars;
+    std::function<bool(const QString &)> m_itemFilter;
+};
+
+#endif // REVIEWSCHEDULER_H
@@ -0,0 +1,88 @@
+#include "RxLogModel.h"
+
+RxLogModel::RxLogModel(int maxLines, QObject *parent)
+    : QObject(parent), m_lines(qMax(1, maxLines))
+{
+}
+
+int RxLogModel::newLine()
+{
+    if (m_count < m_lines.size()) {
+        lineAt(m_count).clear();
+        m_count++;
+        return 0;
+    }
+    // Full: the oldest slot becomes the new last line
+    m_lines[m_head].clear();
+    m_head = (m_head + 1) % m_lines.size();
+    return 1;
+}
+
+void RxLogModel::append(const QString &received)
+{
+    QString text = received;
+    text.remove('\r');
+    if (text.isEmpty()) return;
+    int dropped = 0;
+    if (m_count == 0) dropped += newLine();
+    int firstChanged = m_count - 1;
+
+    int start = 0;
+    while (start < text.size()) {
+        int nl = text.indexOf('\n', start);
+        int end = nl < 0 ? text.size() : nl;
+
+        // Fill the open line, wrapping overlong ones
+        for (int pos = start; pos < end;) {
+            QString &last = lineAt(m_count - 1);
+            if (last.size() >= MaxLineLength) {
+                dropped += newLine();
+                continue;
+            }
+            int take = qMin(end - pos, int(MaxLineLength - last.size()));
+            last.append(QStringView(text).mid(pos, take));
+            pos += take;
+        }
+        if (nl < 0) break;
+        dropped += newLine();
+        start = nl + 1;
+    }
+
+    // Lines that were dropped shift every index down
+    firstChanged = qMax(0, firstChanged - dropped);
+    emit linesChanged(firstChanged, dropped);
+}
+
+void RxLogModel::clear()
+{
+    for (QString &line : m_lines) line = QString();
+    m_head = 0;
+    m_count = 0;
+    emit cleared();
+}
+
+void RxLogModel::setMaxLines(int maxLines)
+{
+    maxLines = qMax(1, maxLines);
+    if (maxLines == m_lines.size()) return;
+
+    // Re-pack the most recent lines into a buffer of the new size
+    int keep = qMin(m_count, maxLines);
+    int dropped = m_count - keep;
+    QVector<QString> lines(maxLines);
+    for (int i = 0; i < keep; ++i) lines[i] = line(dropped + i);
+    m_lines = lines;
+    m_head = 0;
+    m_count = keep;
+    emit linesChanged(0, dropped);
+}
+
+QString RxLogModel::text() const
+{
+    QString all;
+    for (int i = 0; i < m_count; ++i) {
+        if (i > 0) all += '\n';
+        all += line(i);
+    }
+    return all;
+}
@@ -0,0 +1,53 @@
+#ifndef RXLOGMODEL_H
+#define RXLOGMODEL_H
+
+// Include standard Qt classes for objects, strings and containers
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+// Text received from the device, kept as a bounded list of lines.
+// Lines live in a ring buffer: once maxLines is reached every new line
+// overwrites the oldest one, so memory and the cost of an append stay constant
+// however long the device keeps talking. The last line is open and grows until
+// a newline arrives (or it reaches MaxLineLength and wraps).
+class RxLogModel : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int DefaultMaxLines = 5000;
+    static constexpr int MaxLineLength = 512;
+
+    explicit RxLogModel(int maxLines = DefaultMaxLines, QObject *parent = nullptr);
+
+    // Appends received text ('\n' starts a new line, '\r' is ignored)
+    void append(const QString &received);
+    void clear();
+
+    // Retained lines; changing the cap keeps the most recent ones
+    void setMaxLines(int maxLines);
+    int maxLines() const { return m_lines.size(); }
+
+    int lineCount() const { return m_count; }
+    // Line i, 0 being the oldest retained line
+    const QString &line(int i) const { return m_lines[(m_head + i) % m_lines.size()]; }
+    // All retained lines joined (for copying)
+    QString text() const;
+
+signals:
+    // Lines from firstChanged to the end changed or were added;
+    // dropped lines were removed from the front first
+    void linesChanged(int firstChanged, int dropped);
+    void cleared();
+
+private:
+    QString &lineAt(int i) { return m_lines[(m_head + i) % m_lines.size()]; }
+    // Opens a new empty last line, dropping the oldest one if full
+    int newLine();
+
+    QVector<QString> m_lines; // Ring buffer, capacity = maxLines
+    int m_head = 0;           // Slot of the oldest line
+    int m_count = 0;          // Lines in use
+};
+
+#endif // RXLOGMODEL_H
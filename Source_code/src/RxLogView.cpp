@@ -0,0 +1,135 @@
+#include "RxLogView.h"
+#include <QPainter>
+#include <QScrollBar>
+#include <QKeyEvent>
+#include <QContextMenuEvent>
+#include <QMenu>
+#include <QGuiApplication>
+#include <QClipboard>
+#include <QFontDatabase>
+
+namespace {
+const int kMargin = 4; // Left/top padding inside the viewport
+}
+
+RxLogView::RxLogView(QWidget *parent)
+    : QAbstractScrollArea(parent)
+{
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    viewport()->setBackgroundRole(QPalette::Base);
+    viewport()->setAutoFillBackground(true);
+    setFocusPolicy(Qt::StrongFocus);
+    verticalScrollBar()->setSingleStep(1);
+}
+
+void RxLogView::setModel(RxLogModel *model)
+{
+    if (m_model) disconnect(m_model, nullptr, this, nullptr);
+    m_model = model;
+    m_contentWidth = 0;
+    if (m_model) {
+        connect(m_model, &RxLogModel::linesChanged, this, &RxLogView::onLinesChanged);
+        connect(m_model, &RxLogModel::cleared, this, [this]() {
+            m_contentWidth = 0;
+            updateScrollBars();
+            viewport()->update();
+        });
+    }
+    updateScrollBars();
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    viewport()->update();
+}
+
+int RxLogView::lineHeight() const
+{
+    return fontMetrics().lineSpacing();
+}
+
+int RxLogView::visibleLines() const
+{
+    return qMax(1, (viewport()->height() - kMargin) / lineHeight());
+}
+
+bool RxLogView::atBottom() const
+{
+    return verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+}
+
+void RxLogView::onLinesChanged(int firstChanged, int dropped)
+{
+    const bool follow = atBottom();
+    const int value = verticalScrollBar()->value();
+
+    // Only the changed lines can widen the content
+    const QFontMetrics fm = fontMetrics();
+    for (int i = firstChanged; i < m_model->lineCount(); ++i) {
+        m_contentWidth = qMax(m_contentWidth, fm.horizontalAdvance(m_model->line(i)));
+    }
+
+    updateScrollBars();
+    // Stay at the bottom, or keep showing the same lines
+    verticalScrollBar()->setValue(follow ? verticalScrollBar()->maximum() : value - dropped);
+    viewport()->update();
+}
+
+void RxLogView::updateScrollBars()
+{
+    const int lines = m_model ? m_model->lineCount() : 0;
+    const int page = visibleLines();
+    verticalScrollBar()->setPageStep(page);
+    verticalScrollBar()->setRange(0, qMax(0, lines - page));
+
+    const int width = viewport()->width() - 2 * kMargin;
+    horizontalScrollBar()->setPageStep(width);
+    horizontalScrollBar()->setSingleStep(fontMetrics().averageCharWidth());
+    horizontalScrollBar()->setRange(0, qMax(0, m_contentWidth - width));
+}
+
+void RxLogView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    if (!m_model) return;
+
+    QPainter painter(viewport());
+    painter.setPen(palette().color(QPalette::Text));
+    const QFontMetrics fm = fontMetrics();
+    const int h = lineHeight();
+    const int first = verticalScrollBar()->value();
+    const int last = qMin(m_model->lineCount(), first + visibleLines() + 1);
+    const int x = kMargin - horizontalScrollBar()->value();
+
+    // Only the lines in the viewport are laid out
+    for (int i = first; i < last; ++i) {
+        int y = kMargin + (i - first) * h + fm.ascent();
+        painter.drawText(x, y, m_model->line(i));
+    }
+}
+
+void RxLogView::resizeEvent(QResizeEvent *event)
+{
+    const bool follow = atBottom();
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+    if (follow) verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+void RxLogView::keyPressEvent(QKeyEvent *event)
+{
+    if (event->matches(QKeySequence::Copy)) {
+        copyAll();
+        return;
+    }
+    QAbstractScrollArea::keyPressEvent(event);
+}
+
+void RxLogView::contextMenuEvent(QContextMenuEvent *event)
+{
+    QMenu menu(this);
+    menu.addAction("Copy Log", this, &RxLogView::copyAll);
+    menu.exec(event->globalPos());
+}
+
+void RxLogView::copyAll()
+{
+    if (m_model) QGuiApplication::clipboard()->setText(m_model->text());
+}
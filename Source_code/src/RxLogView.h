@@ -0,0 +1,40 @@
+#ifndef RXLOGVIEW_H
+#define RXLOGVIEW_H
+
+// Include necessary Qt widget classes
+#include <QAbstractScrollArea>
+#include "RxLogModel.h"
+
+// Read-only view of an RxLogModel.
+// Only the lines inside the viewport are drawn, one fixed-height row per
+// line, so painting and scrolling cost the same for ten lines or ten thousand.
+// The view follows new text while it is scrolled to the bottom and otherwise
+// keeps its position (also when old lines drop off the front).
+class RxLogView : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    explicit RxLogView(QWidget *parent = nullptr);
+
+    void setModel(RxLogModel *model);
+    RxLogModel *model() const { return m_model; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+
+private:
+    void onLinesChanged(int firstChanged, int dropped);
+    void updateScrollBars();
+    int lineHeight() const;
+    int visibleLines() const;
+    bool atBottom() const;
+    void copyAll();
+
+    RxLogModel *m_model = nullptr;
+    int m_contentWidth = 0; // Widest line seen (pixels); reset on clear
+};
+
+#endif // RXLOGVIEW_H
@@ -1,6 +1,26 @@
 #include "SerialManager.h"
 #include <QDebug>
 
+namespace {
+// Status lines of the device, in SystemMessage order. A pattern must start
+// the line (leading whitespace aside). Decoded Morse is upper case, so keyed
+// text leaves the table after a character or two.
+const QLatin1String kSystemPatterns[] = {
+    QLatin1String("WPM set to"),
+    QLatin1String("Tone set to"),
+    QLatin1String("Mode set to"),
+    QLatin1String("Action:"),
+    QLatin1String("Encoded:"),
+    QLatin1String("[Done]"),
+};
+const int kPatternCount = int(sizeof(kSystemPatterns) / sizeof(kSystemPatterns[0]));
+const quint32 kAllPatterns = (1u << kPatternCount) - 1;
+
+// A status line arrives in one burst; a partial line that has not become
+// one after this long is ordinary text
+const int kHoldMs = 30;
+}
+
 // Constructor
 SerialManager::SerialManager(QObject *parent) : QObject(parent)
 {
@@ -10,6 +30,13 @@ SerialManager::SerialManager(QObject *parent) : QObject(parent)
     connect(m_serial, &QSerialPort::readyRead, this, &SerialManager::onReadyRead);
     // Connect errorOccurred signal to onError slot to handle errors
     connect(m_serial, &QSerialPort::errorOccurred, this, &SerialManager::onError);
+
+    // Releases the start of a line that is still being held back
+    m_holdTimer = new QTimer(this);
+    m_holdTimer->setSingleShot(true);
+    m_holdTimer->setInterval(kHoldMs);
+    connect(m_holdTimer, &QTimer::timeout, this, &SerialManager::releaseHeldText);
+    resetLine();
 }
 
 // Destructor
@@ -47,6 +74,9 @@ bool SerialManager::connectToPort(const QString &portName, int baudRate)
     m_serial->setParity(QSerialPort::NoParity); // No Parity
     m_serial->setStopBits(QSerialPort::OneStop); // 1 Stop bit
     m_serial->setFlowControl(QSerialPort::NoFlowControl); // No Flow Control
+    // Start from a clean line
+    m_holdTimer->stop();
+    resetLine();
 
     // Attempt to open port in Read/Write mode
     if (m_serial->open(QIODevice::ReadWrite)) {
@@ -92,50 +122,129 @@ void SerialManager::sendCommand(const QString &command)
 void SerialManager::onReadyRead()
 {
     // Read all available data immediately (don't wait for newlines)
-    QByteArray data = m_serial->readAll();
-    if (!data.isEmpty()) {
-        // Convert raw bytes to string
-        QString str = QString::fromUtf8(data);
-        
-        // Scan for Real-Time Tone Tokens
-        if (str.contains('[')) {
-            emit toneStartReceived();
-            str.replace("[", ""); // Remove token
+    processData(m_serial->readAll());
+}
+
+// Parse received bytes
+void SerialManager::processData(const QByteArray &data)
+{
+    if (data.isEmpty()) return;
+    // Convert raw bytes to string
+    const QString str = QString::fromUtf8(data);
+    m_holdTimer->stop();
+
+    // Walk the text once: tone tokens, line ends and the pattern table
+    // are all handled per character
+    QString out;
+    for (QChar c : str) {
+        if (c == '\n') {
+            finishLine(out);
+            continue;
+        }
+        // Real-Time Tone Tokens: reported at once, never displayed
+        const bool toneToken = (c == '[' || c == ']');
+        if (c == '[') emit toneStartReceived();
+        else if (c == ']') emit toneStopReceived();
+        feedLine(c, toneToken, out);
+    }
+
+    // Emit raw text immediately for UI updates
+    flushText(out);
+
+    // The start of a possible system line waits briefly for the rest
+    if (m_lineState == LineState::Undecided && m_matchPos > 0) {
+        m_holdTimer->start();
+    }
+}
+
+void SerialManager::feedLine(QChar c, bool toneToken, QString &out)
+{
+    if (!toneToken) m_buffer += c;
+
+    if (m_lineState == LineState::Text) {
+        if (!toneToken) out += c;
+        return;
+    }
+    if (m_lineState == LineState::System) return;
+
+    // Undecided: hold the text back until the table has an answer
+    if (!toneToken) m_held += c;
+    if (m_matchPos == 0 && c.isSpace()) return;
+
+    // Drop every pattern that differs at this position
+    for (int i = 0; i < kPatternCount; ++i) {
+        const quint32 bit = 1u << i;
+        if ((m_candidates & bit) && QChar(kSystemPatterns[i].at(m_matchPos)) != c) {
+            m_candidates &= ~bit;
         }
-        if (str.contains(']')) {
-            emit toneStopReceived();
-            str.replace("]", ""); // Remove token
+    }
+    m_matchPos++;
+
+    if (m_candidates == 0) {
+        // Ordinary text after all: show what was held back
+        m_lineState = LineState::Text;
+        out += m_held;
+        m_held.clear();
+        return;
+    }
+    for (int i = 0; i < kPatternCount; ++i) {
+        if ((m_candidates & (1u << i)) && kSystemPatterns[i].size() == m_matchPos) {
+            // Complete pattern: the rest of the line is its value
+            m_lineState = LineState::System;
+            m_systemKind = SystemMessage(i);
+            m_valueStart = m_buffer.size();
+            m_held.clear();
+            return;
         }
+    }
+}
 
-        // If string became empty, return
-        if (str.isEmpty()) return;
-
-        // Emit raw text immediately for UI updates
-        emit textReceived(str);
-        
-        // Split by newlines for line-by-line emission
-        QStringList lines = str.split('\n', Qt::KeepEmptyParts);
-        
-        for (int i = 0; i < lines.size(); ++i) {
-            QString line = lines[i];
-            
-            // If this is the last chunk and it didn't end with a newline, it's incomplete
-            if (i == lines.size() - 1 && !str.endsWith('\n')) {
-                // Buffer it for next read
-                m_buffer += line;
-            } else {
-                // Complete line - combine with buffer if any
-                QString completeLine = m_buffer + line;
-                m_buffer.clear(); // Clear buffer
-                completeLine = completeLine.trimmed(); // Remove whitespace
-                
-                // Emit signal if line is not empty
-                if (!completeLine.isEmpty()) {
-                    emit lineReceived(completeLine);
-                }
-            }
+void SerialManager::finishLine(QString &out)
+{
+    if (m_lineState == LineState::System) {
+        // Text before the line goes out first, then the line on its own channel
+        flushText(out);
+        const QString rest = m_buffer.mid(m_valueStart);
+        emit systemLineReceived(m_systemKind, rest.trimmed(),
+                                (QString(kSystemPatterns[int(m_systemKind)]) + rest).trimmed());
+    } else {
+        out += m_held;
+        out += '\n';
+        // Complete line - remove whitespace and emit if not empty
+        const QString completeLine = m_buffer.trimmed();
+        if (!completeLine.isEmpty()) {
+            flushText(out);
+            emit lineReceived(completeLine);
         }
     }
+    resetLine();
+}
+
+void SerialManager::flushText(QString &out)
+{
+    if (out.isEmpty()) return;
+    emit textReceived(out);
+    out.clear();
+}
+
+void SerialManager::releaseHeldText()
+{
+    if (m_lineState != LineState::Undecided || m_matchPos == 0) return;
+    // No status line arrives this slowly: it is text typed on the paddle
+    m_lineState = LineState::Text;
+    QString out = m_held;
+    m_held.clear();
+    flushText(out);
+}
+
+void SerialManager::resetLine()
+{
+    m_buffer.clear();
+    m_held.clear();
+    m_lineState = LineState::Undecided;
+    m_candidates = kAllPatterns;
+    m_matchPos = 0;
+    m_valueStart = 0;
 }
 
 // Handle serial errors
@@ -9,19 +9,25 @@
 #include <QSerialPortInfo>
 // Include QStringList for handling lists of strings
 #include <QStringList>
+// Include QTimer to release held-back text
+#include <QTimer>
 
 // Class responsible for managing serial port connections and data transfer
 class SerialManager : public QObject
 {
     Q_OBJECT // Macro required for Qt signals and slots
 public:
+    // Status lines printed by the device (one entry per pattern in the table)
+    enum class SystemMessage { WpmSet, ToneSet, ModeSet, Action, Encoded, Done };
+    Q_ENUM(SystemMessage)
+
     // Constructor: Initializes the serial manager
     explicit SerialManager(QObject *parent = nullptr);
     // Destructor: Cleans up serial resources
     ~SerialManager();
 
-    // Returns a list of names of available serial ports
-    QStringList getAvailablePorts();
+    // Returns a list of names of available serial ports (safe on any thread)
+    static QStringList getAvailablePorts();
     
     // Attempts to connect to a specific port with a given baud rate
     // Returns true if successful, false otherwise
@@ -36,12 +42,19 @@ public:
     // Sends a text command to the connected serial device
     void sendCommand(const QString &command);
 
+    // Parses bytes as if they had just been read from the port
+    // (the whole receive path; also used to replay recorded streams)
+    void processData(const QByteArray &data);
+
 signals:
-    // Emitted when raw text is received (for immediate display)
-    // Emitted when raw text is received (for immediate display)
+    // Emitted when raw text is received (for immediate display).
+    // Never contains tone tokens or system lines.
     void textReceived(QString text);
     // Emitted when a complete line of text is received (terminated by newline)
     void lineReceived(QString line);
+    // Emitted instead of the above for a status line of the device.
+    // value: the text after the pattern, line: the whole line (trimmed)
+    void systemLineReceived(SerialManager::SystemMessage kind, QString value, QString line);
     
     // Real-Time Tone Signals
     void toneStartReceived();
@@ -60,12 +73,38 @@ private slots:
     void onReadyRead();
     // Slot called when a serial port error occurs
     void onError(QSerialPort::SerialPortError error);
+    // Held-back text did not turn into a system line in time
+    void releaseHeldText();
 
 private:
+    // Where the current line stands in the pattern table
+    enum class LineState { Undecided, Text, System };
+
+    // Feeds one character of the current line; displayable text goes to out
+    void feedLine(QChar c, bool toneToken, QString &out);
+    // Ends the current line at a newline
+    void finishLine(QString &out);
+    // Emits the text collected so far (keeps output in stream order)
+    void flushText(QString &out);
+    // Forgets any partial line
+    void resetLine();
+
     // Pointer to the QSerialPort instance
     QSerialPort *m_serial;
     // Buffer to store incoming data until a newline is received
     QString m_buffer; 
+
+    // Line classification: every pattern still matching the start of the
+    // current line is a bit in m_candidates, so each character costs one
+    // comparison per live pattern and nothing is ever searched twice.
+    LineState m_lineState = LineState::Undecided;
+    quint32 m_candidates = 0;   // Patterns the line can still become
+    int m_matchPos = 0;         // Characters matched (after leading whitespace)
+    SystemMessage m_systemKind = SystemMessage::Action;
+    int m_valueStart = 0;       // Position in m_buffer after the pattern
+    // Start of the line, held back while it may still be a system line
+    QString m_held;
+    QTimer *m_holdTimer;
 };
 
 #endif // SERIALMANAGER_H
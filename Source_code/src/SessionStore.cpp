@@ -0,0 +1,582 @@
+#include "SessionStore.h"
+#include <QSaveFile>
+#include <QTextStream>
+#include <QHash>
+#include <QDebug>
+#include <cstring>
+
+// The file is written and mapped in host order; all supported targets are little-endian
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN, "SessionStore assumes a little-endian host");
+
+// Fixed-size file header (64 bytes)
+struct SessionStore::Header {
+    char magic[4];
+    quint32 version;
+    quint32 columnCount;
+    quint32 reserved0;
+    quint64 rowCount;
+    quint64 rowCapacity;
+    quint64 heapOffset;
+    quint64 heapSize;
+    quint64 heapCapacity;
+    quint64 reserved1;
+};
+
+// Column directory entry (40 bytes)
+struct SessionStore::ColumnDesc {
+    char name[24];
+    quint32 type;
+    quint32 width;  // Bytes per row
+    quint64 offset; // File offset of the column array
+};
+
+namespace {
+const char kMagic[4] = {'C', 'W', 'S', 'S'};
+const quint64 kMinRowCapacity = 256;
+const quint64 kMinHeapCapacity = 64 * 1024;
+
+quint64 align8(quint64 v) { return (v + 7) & ~quint64(7); }
+
+// Storage type of each logical column
+SessionStore::ColumnType columnType(int column)
+{
+    switch (column) {
+    case SessionStore::ColStart: return SessionStore::Int64;
+    case SessionStore::ColAccuracy: return SessionStore::Float32;
+    case SessionStore::ColMode:
+    case SessionStore::ColItems: return SessionStore::Blob;
+    default: return SessionStore::Int32;
+    }
+}
+
+quint32 typeWidth(quint32 type)
+{
+    switch (type) {
+    case SessionStore::Int64: return 8;
+    case SessionStore::Blob: return 8; // (heap offset, length) as two quint32
+    default: return 4;
+    }
+}
+
+// Reads the Int32 value of a record for a logical column
+qint32 int32Value(const SessionRecord &r, int column)
+{
+    switch (column) {
+    case SessionStore::ColDuration: return r.duration;
+    case SessionStore::ColAttempts: return r.attempts;
+    case SessionStore::ColCorrect: return r.correct;
+    case SessionStore::ColWrong: return r.wrong;
+    case SessionStore::ColWpm: return r.wpm;
+    case SessionStore::ColTone: return r.tone;
+    default: break;
+    }
+    if (column >= SessionStore::ColLatencyBase) {
+        int k = column - SessionStore::ColLatencyBase;
+        const CharLatency &cl = r.latency[k / 2];
+        return k % 2 == 0 ? cl.count : cl.totalMs;
+    }
+    int k = column - SessionStore::ColCharBase;
+    const CharCounts &cc = r.chars[k / 3];
+    return k % 3 == 0 ? cc.total : (k % 3 == 1 ? cc.ok : cc.err);
+}
+}
+
+SessionStore::SessionStore(const QString &path) : m_path(path)
+{
+}
+
+SessionStore::~SessionStore()
+{
+    close();
+}
+
+QString SessionStore::columnName(int column)
+{
+    switch (column) {
+    case ColStart: return QStringLiteral("StartTime");
+    case ColDuration: return QStringLiteral("Duration");
+    case ColAttempts: return QStringLiteral("Attempts");
+    case ColCorrect: return QStringLiteral("Correct");
+    case ColWrong: return QStringLiteral("Wrong");
+    case ColAccuracy: return QStringLiteral("Accuracy");
+    case ColWpm: return QStringLiteral("WPM");
+    case ColTone: return QStringLiteral("Tone");
+    case ColMode: return QStringLiteral("Mode");
+    case ColItems: return QStringLiteral("Item_Stats");
+    default: break;
+    }
+    if (column >= ColLatencyBase) {
+        static const char *latencySuffix[2] = {"_LatN", "_LatMs"};
+        int k = column - ColLatencyBase;
+        return CharIndex::label(k / 2) + latencySuffix[k % 2];
+    }
+    static const char *suffix[3] = {"_Total", "_OK", "_Err"};
+    int k = column - ColCharBase;
+    return CharIndex::label(k / 3) + suffix[k % 3];
+}
+
+int SessionStore::columnForName(const QString &name)
+{
+    // Built once, on first use
+    static const QHash<QString, int> lookup = [] {
+        QHash<QString, int> h;
+        for (int c = 0; c < ColumnCount; ++c) h.insert(columnName(c), c);
+        return h;
+    }();
+    return lookup.value(name, -1);
+}
+
+// --- Reading ---
+
+bool SessionStore::open()
+{
+    close();
+    m_file.setFileName(m_path);
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+
+    m_mapSize = m_file.size();
+    if (m_mapSize < qint64(sizeof(Header))) { close(); return false; }
+    m_map = m_file.map(0, m_mapSize);
+    if (!m_map) { close(); return false; }
+
+    const Header *h = header();
+    if (std::memcmp(h->magic, kMagic, 4) != 0 ||
+        qint64(sizeof(Header) + h->columnCount * sizeof(ColumnDesc)) > m_mapSize ||
+        h->rowCount > h->rowCapacity) {
+        qWarning() << "Invalid statistics store" << m_path;
+        close();
+        return false;
+    }
+
+    // Resolve columns by name so the file's column order does not matter
+    m_columnSlots = QVector<int>(ColumnCount, -1);
+    const ColumnDesc *dir = reinterpret_cast<const ColumnDesc *>(m_map + sizeof(Header));
+    for (quint32 i = 0; i < h->columnCount; ++i) {
+        QString name = QString::fromLatin1(dir[i].name, int(qstrnlen(dir[i].name, sizeof(dir[i].name))));
+        int column = columnForName(name);
+        if (column < 0) continue;
+        if (dir[i].width != typeWidth(dir[i].type) ||
+            qint64(dir[i].offset + quint64(dir[i].width) * h->rowCapacity) > m_mapSize) continue;
+        m_columnSlots[column] = int(i);
+    }
+    return true;
+}
+
+void SessionStore::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_mapSize = 0;
+    m_file.close();
+    m_columnSlots.clear();
+}
+
+const SessionStore::Header *SessionStore::header() const
+{
+    static_assert(sizeof(Header) == 64 && sizeof(ColumnDesc) == 40, "On-disk layout changed");
+    return reinterpret_cast<const Header *>(m_map);
+}
+
+qint64 SessionStore::rowCount() const
+{
+    return m_map ? qint64(header()->rowCount) : 0;
+}
+
+const uchar *SessionStore::columnData(int column, ColumnType type) const
+{
+    if (!m_map || column < 0 || column >= m_columnSlots.size()) return nullptr;
+    int slot = m_columnSlots[column];
+    if (slot < 0) return nullptr;
+    const ColumnDesc *dir = reinterpret_cast<const ColumnDesc *>(m_map + sizeof(Header));
+    if (dir[slot].type != quint32(type)) return nullptr;
+    return m_map + dir[slot].offset;
+}
+
+const qint32 *SessionStore::int32Column(int column) const
+{
+    return reinterpret_cast<const qint32 *>(columnData(column, Int32));
+}
+
+const qint64 *SessionStore::int64Column(int column) const
+{
+    return reinterpret_cast<const qint64 *>(columnData(column, Int64));
+}
+
+const float *SessionStore::float32Column(int column) const
+{
+    return reinterpret_cast<const float *>(columnData(column, Float32));
+}
+
+QString SessionStore::blob(int column, qint64 row) const
+{
+    const quint32 *refs = reinterpret_cast<const quint32 *>(columnData(column, Blob));
+    if (!refs) return QString();
+    const Header *h = header();
+    quint32 offset = refs[2 * row];
+    quint32 length = refs[2 * row + 1];
+    if (offset + quint64(length) > h->heapSize || qint64(h->heapOffset + h->heapSize) > m_mapSize) return QString();
+    return QString::fromUtf8(reinterpret_cast<const char *>(m_map + h->heapOffset + offset), int(length));
+}
+
+SessionRecord SessionStore::row(qint64 index) const
+{
+    SessionRecord r;
+    if (index < 0 || index >= rowCount()) return r;
+
+    if (const qint64 *start = int64Column(ColStart)) r.start = QDateTime::fromMSecsSinceEpoch(start[index]);
+    if (const float *acc = float32Column(ColAccuracy)) r.accuracy = acc[index];
+    r.mode = blob(ColMode, index);
+    r.items = blob(ColItems, index);
+
+    auto get = [&](int column) -> qint32 {
+        const qint32 *data = int32Column(column);
+        return data ? data[index] : 0;
+    };
+    r.duration = get(ColDuration);
+    r.attempts = get(ColAttempts);
+    r.correct = get(ColCorrect);
+    r.wrong = get(ColWrong);
+    r.wpm = get(ColWpm);
+    r.tone = get(ColTone);
+    for (int id = 0; id < CharIndex::TrackedCount; ++id) {
+        r.chars[id].total = get(charColumn(id, 0));
+        r.chars[id].ok = get(charColumn(id, 1));
+        r.chars[id].err = get(charColumn(id, 2));
+        r.latency[id].count = get(latencyColumn(id, 0));
+        r.latency[id].totalMs = get(latencyColumn(id, 1));
+    }
+    return r;
+}
+
+// --- Writing ---
+
+namespace {
+// File offsets of everything that follows the header for a given row capacity
+struct Layout {
+    QVector<quint64> offsets; // Column array per logical column
+    quint64 heapOffset = 0;
+};
+
+Layout layoutFor(quint64 rowCapacity)
+{
+    Layout l;
+    l.offsets.resize(SessionStore::ColumnCount);
+    quint64 cursor = align8(64 + quint64(SessionStore::ColumnCount) * 40);
+    for (int c = 0; c < SessionStore::ColumnCount; ++c) {
+        l.offsets[c] = cursor;
+        cursor = align8(cursor + typeWidth(columnType(c)) * rowCapacity);
+    }
+    l.heapOffset = cursor;
+    return l;
+}
+
+// Header and column directory of the current schema, padded up to the first column
+QByteArray headerBlock(const Layout &l, quint64 rowCount, quint64 rowCapacity, quint64 heapSize, quint64 heapCapacity)
+{
+    QByteArray buf(qsizetype(l.offsets[0]), '\0');
+    uchar *base = reinterpret_cast<uchar *>(buf.data());
+
+    quint32 version = SessionStore::SchemaVersion;
+    quint32 columnCount = quint32(SessionStore::ColumnCount);
+    std::memcpy(base, kMagic, 4);
+    std::memcpy(base + 4, &version, 4);
+    std::memcpy(base + 8, &columnCount, 4);
+    std::memcpy(base + 16, &rowCount, 8);
+    std::memcpy(base + 24, &rowCapacity, 8);
+    std::memcpy(base + 32, &l.heapOffset, 8);
+    std::memcpy(base + 40, &heapSize, 8);
+    std::memcpy(base + 48, &heapCapacity, 8);
+
+    for (int c = 0; c < SessionStore::ColumnCount; ++c) {
+        uchar *d = base + 64 + c * 40;
+        QByteArray name = SessionStore::columnName(c).toLatin1().left(23);
+        std::memcpy(d, name.constData(), name.size());
+        quint32 type = columnType(c);
+        quint32 width = typeWidth(type);
+        std::memcpy(d + 24, &type, 4);
+        std::memcpy(d + 28, &width, 4);
+        std::memcpy(d + 32, &l.offsets[c], 8);
+    }
+    return buf;
+}
+
+// Appends n zero bytes without allocating n bytes
+bool writeZeros(QIODevice &out, quint64 n)
+{
+    static const char zeros[64 * 1024] = {};
+    while (n > 0) {
+        qint64 chunk = qint64(qMin<quint64>(n, sizeof(zeros)));
+        if (out.write(zeros, chunk) != chunk) return false;
+        n -= quint64(chunk);
+    }
+    return true;
+}
+
+// Smallest doubling of base (at least minimum) that holds needed
+quint64 grownCapacity(quint64 base, quint64 minimum, quint64 needed)
+{
+    quint64 capacity = qMax(base, minimum);
+    while (capacity < needed) capacity *= 2;
+    return capacity;
+}
+}
+
+// Builds a complete store file with the given capacities
+static QByteArray buildStore(const QVector<SessionRecord> &records, quint64 rowCapacity, quint64 heapCapacity)
+{
+    using Store = SessionStore;
+    const int ncols = Store::ColumnCount;
+
+    // Heap first, so every blob reference is known
+    QByteArray heap;
+    QVector<quint32> refs; // (offset, length) for Mode then Items, per row
+    refs.reserve(records.size() * 4);
+    for (const SessionRecord &r : records) {
+        for (const QString *s : {&r.mode, &r.items}) {
+            QByteArray utf8 = s->toUtf8();
+            refs.append(quint32(heap.size()));
+            refs.append(quint32(utf8.size()));
+            heap.append(utf8);
+        }
+    }
+    heapCapacity = qMax(heapCapacity, quint64(heap.size()));
+
+    const Layout l = layoutFor(rowCapacity);
+    QByteArray buf = headerBlock(l, quint64(records.size()), rowCapacity, quint64(heap.size()), heapCapacity);
+    buf.resize(qsizetype(l.heapOffset + heapCapacity), '\0');
+    uchar *base = reinterpret_cast<uchar *>(buf.data());
+
+    // Column arrays
+    for (int i = 0; i < records.size(); ++i) {
+        const SessionRecord &r = records[i];
+        qint64 start = r.start.toMSecsSinceEpoch();
+        std::memcpy(base + l.offsets[Store::ColStart] + i * 8, &start, 8);
+        std::memcpy(base + l.offsets[Store::ColAccuracy] + i * 4, &r.accuracy, 4);
+        std::memcpy(base + l.offsets[Store::ColMode] + i * 8, &refs[i * 4], 8);
+        std::memcpy(base + l.offsets[Store::ColItems] + i * 8, &refs[i * 4 + 2], 8);
+        for (int c = 0; c < ncols; ++c) {
+            if (columnType(c) != Store::Int32) continue;
+            qint32 v = int32Value(r, c);
+            std::memcpy(base + l.offsets[c] + i * 4, &v, 4);
+        }
+    }
+
+    // Heap
+    std::memcpy(base + l.heapOffset, heap.constData(), heap.size());
+    return buf;
+}
+
+bool SessionStore::writeStore(const QString &path, const QVector<SessionRecord> &records)
+{
+    // Leave headroom so the next appends do not trigger another rewrite
+    quint64 heapBytes = 0;
+    for (const SessionRecord &r : records) heapBytes += quint64(r.mode.toUtf8().size() + r.items.toUtf8().size());
+    quint64 rowCapacity = grownCapacity(kMinRowCapacity, kMinRowCapacity, quint64(records.size()) * 2);
+    quint64 heapCapacity = grownCapacity(kMinHeapCapacity, kMinHeapCapacity, heapBytes * 2);
+
+    // QSaveFile writes to a temporary file and renames it over the old one
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(buildStore(records, rowCapacity, heapCapacity));
+    return file.commit();
+}
+
+bool SessionStore::migrate()
+{
+    close();
+    if (!QFile::exists(m_path)) return true;
+    if (!open()) return false;
+
+    const quint32 version = header()->version;
+    bool complete = true;
+    for (int c = 0; c < ColumnCount; ++c) complete = complete && columnData(c, columnType(c));
+
+    // Nothing to do if current; a store from a newer build is left alone,
+    // since rewriting it would drop the columns this build does not know
+    if (version > SchemaVersion || (version == SchemaVersion && complete)) {
+        close();
+        return version == SchemaVersion || complete;
+    }
+
+    if (rewrite(0, 0)) return true;
+    qWarning() << "Could not migrate" << m_path << "from schema" << version << "to" << SchemaVersion;
+    return false;
+}
+
+// Streams the mapped store into a new file with the current schema and room
+// for extraRows more rows and extraHeap more heap bytes. Columns are matched by
+// name: existing ones are copied as one contiguous block each, columns new in
+// this schema start out as zeros. Blob references stay valid because the heap
+// is copied verbatim. The new file replaces the old one only on commit.
+bool SessionStore::rewrite(quint64 extraRows, quint64 extraHeap)
+{
+    if (!isOpen() && !open()) return false;
+
+    const Header src = *header();
+    const quint64 rows = src.rowCount;
+    if (src.heapOffset + src.heapSize > quint64(m_mapSize)) {
+        close();
+        return false;
+    }
+    const quint64 rowCapacity = grownCapacity(src.rowCapacity, kMinRowCapacity, rows + extraRows);
+    const quint64 heapCapacity = grownCapacity(src.heapCapacity, kMinHeapCapacity, src.heapSize + extraHeap);
+    const Layout l = layoutFor(rowCapacity);
+
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        close();
+        return false;
+    }
+
+    bool ok = file.write(headerBlock(l, rows, rowCapacity, src.heapSize, heapCapacity)) == qint64(l.offsets[0]);
+    for (int c = 0; c < ColumnCount && ok; ++c) {
+        const quint64 width = typeWidth(columnType(c));
+        const quint64 used = rows * width;
+        const quint64 next = c + 1 < ColumnCount ? l.offsets[c + 1] : l.heapOffset;
+        if (const uchar *data = columnData(c, columnType(c))) {
+            ok = file.write(reinterpret_cast<const char *>(data), qint64(used)) == qint64(used);
+        } else {
+            ok = writeZeros(file, used);
+        }
+        // Free slots plus alignment padding
+        ok = ok && writeZeros(file, next - l.offsets[c] - used);
+    }
+    ok = ok && file.write(reinterpret_cast<const char *>(m_map + src.heapOffset), qint64(src.heapSize)) == qint64(src.heapSize);
+    ok = ok && writeZeros(file, heapCapacity - src.heapSize);
+
+    // The old file must not be mapped while it is replaced (Windows)
+    close();
+    if (!ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool SessionStore::append(const SessionRecord &record)
+{
+    close();
+    if (!QFile::exists(m_path)) return writeStore(m_path, {record});
+
+    bool needsRewrite = false;
+    if (appendInPlace(record, needsRewrite)) return true;
+    if (!needsRewrite) return false;
+
+    // Out of room or an older schema: rewrite once, then append in place
+    quint64 heapBytes = quint64(record.mode.toUtf8().size() + record.items.toUtf8().size());
+    if (!rewrite(1, heapBytes)) return false;
+    return appendInPlace(record, needsRewrite);
+}
+
+// Writes the row into the free slots, then publishes it by bumping the row count
+bool SessionStore::appendInPlace(const SessionRecord &record, bool &needsRewrite)
+{
+    needsRewrite = false;
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadWrite)) return false;
+
+    Header h;
+    if (file.read(reinterpret_cast<char *>(&h), sizeof(h)) != qint64(sizeof(h)) ||
+        std::memcmp(h.magic, kMagic, 4) != 0) {
+        return false;
+    }
+    QVector<ColumnDesc> dir(int(h.columnCount));
+    qint64 dirBytes = qint64(h.columnCount) * qint64(sizeof(ColumnDesc));
+    if (file.read(reinterpret_cast<char *>(dir.data()), dirBytes) != dirBytes) return false;
+
+    // Map the file's directory onto our columns
+    QVector<int> slots(ColumnCount, -1);
+    for (int i = 0; i < dir.size(); ++i) {
+        int column = columnForName(QString::fromLatin1(dir[i].name, int(qstrnlen(dir[i].name, sizeof(dir[i].name)))));
+        if (column >= 0 && dir[i].type == quint32(columnType(column))) slots[column] = i;
+    }
+    QByteArray mode = record.mode.toUtf8();
+    QByteArray items = record.items.toUtf8();
+    if (slots.contains(-1)) {
+        // A store from a newer build is never rewritten (its extra columns would be lost)
+        if (h.version > SchemaVersion) {
+            qWarning() << m_path << "was written by a newer version; not appending";
+            return false;
+        }
+        needsRewrite = true;
+        return false;
+    }
+    if (h.version < SchemaVersion || h.rowCount >= h.rowCapacity ||
+        h.heapSize + quint64(mode.size() + items.size()) > h.heapCapacity) {
+        needsRewrite = true;
+        return false;
+    }
+
+    const quint64 row = h.rowCount;
+    auto writeAt = [&](int column, const void *data) {
+        const ColumnDesc &d = dir[slots[column]];
+        file.seek(qint64(d.offset + row * d.width));
+        file.write(reinterpret_cast<const char *>(data), d.width);
+    };
+
+    qint64 start = record.start.toMSecsSinceEpoch();
+    writeAt(ColStart, &start);
+    writeAt(ColAccuracy, &record.accuracy);
+    quint32 modeRef[2] = {quint32(h.heapSize), quint32(mode.size())};
+    quint32 itemsRef[2] = {quint32(h.heapSize + mode.size()), quint32(items.size())};
+    writeAt(ColMode, modeRef);
+    writeAt(ColItems, itemsRef);
+    for (int c = 0; c < ColumnCount; ++c) {
+        if (columnType(c) != Int32) continue;
+        qint32 v = int32Value(record, c);
+        writeAt(c, &v);
+    }
+    file.seek(qint64(h.heapOffset + h.heapSize));
+    file.write(mode);
+    file.write(items);
+    file.flush();
+
+    // Commit point
+    h.rowCount++;
+    h.heapSize += quint64(mode.size() + items.size());
+    file.seek(0);
+    file.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    return file.flush();
+}
+
+// --- CSV export ---
+
+bool SessionStore::exportCsv(const QString &csvPath)
+{
+    if (!open()) return false;
+
+    QSaveFile file(csvPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        // Unmap on every way out, as on success
+        close();
+        return false;
+    }
+    QTextStream out(&file);
+
+    out << "Date,Time";
+    for (int c = ColDuration; c < ColumnCount; ++c) out << "," << columnName(c);
+    out << "\n";
+
+    for (qint64 i = 0; i < rowCount(); ++i) {
+        SessionRecord r = row(i);
+        out << r.start.toString("yyyy-MM-dd") << ","
+            << r.start.toString("HH:mm:ss") << ","
+            << r.duration << ","
+            << r.attempts << ","
+            << r.correct << ","
+            << r.wrong << ","
+            << QString::number(r.accuracy, 'f', 1) << ","
+            << r.wpm << ","
+            << r.tone << ","
+            << r.mode << ","
+            << r.items;
+        for (const CharCounts &cc : r.chars) out << "," << cc.total << "," << cc.ok << "," << cc.err;
+        for (const CharLatency &cl : r.latency) out << "," << cl.count << "," << cl.totalMs;
+        out << "\n";
+    }
+    out.flush();
+    close();
+    return file.commit();
+}
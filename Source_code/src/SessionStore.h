@@ -0,0 +1,150 @@
+#ifndef SESSIONSTORE_H
+#define SESSIONSTORE_H
+
+// Include standard Qt classes for file access, strings and containers
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QDateTime>
+#include <array>
+#include "CharIndex.h"
+
+// Per-character counters of one session, as persisted
+struct CharCounts {
+    qint32 total = 0; // Times the character was given
+    qint32 ok = 0;    // Times it was copied correctly
+    qint32 err = 0;   // Times it was missed
+};
+
+// Per-character recognition latency of one session (see LatencyStats)
+struct CharLatency {
+    qint32 count = 0;   // Correct copies with a measured latency
+    qint32 totalMs = 0; // Sum of those latencies
+};
+
+// One session row, used to append, import and export
+struct SessionRecord {
+    QDateTime start;       // Session start
+    qint32 duration = 0;   // Seconds
+    qint32 attempts = 0;
+    qint32 correct = 0;
+    qint32 wrong = 0;
+    float accuracy = 0;    // Percent
+    qint32 wpm = 0;
+    qint32 tone = 0;
+    QString mode;          // OFFLINE / DEVICE / RECOVERED
+    QString items;         // Item_Stats blob, e.g. "CQ(G:2/OK:1/ERR:1);"
+    std::array<CharCounts, CharIndex::TrackedCount> chars;
+    std::array<CharLatency, CharIndex::TrackedCount> latency;
+};
+
+// Columnar, versioned binary store for session statistics (statistics.cws).
+//
+// Layout (little-endian):
+//   Header     magic "CWSS", schema version, column count, row count/capacity, heap bounds
+//   Directory  one descriptor per column: name, type, width, file offset
+//   Columns    one contiguous array per column, rowCapacity entries each
+//   Heap       UTF-8 bytes referenced by Blob columns (offset, length pairs)
+//
+// Readers memory-map the file and look columns up by name, so opening years
+// of history is a page-in of the columns actually used. Appending writes one
+// slot per column and then bumps the row count in the header, which is the
+// commit point. When a capacity is exhausted the file is rewritten once with
+// doubled capacity, so appends stay amortized O(1).
+//
+// Schema changes bump SchemaVersion. migrate() upgrades an older file by
+// streaming every column into a temporary file with the new layout and
+// renaming it over the original, so an upgrade costs one pass over the file
+// and a crash leaves either the complete old or the complete new store.
+class SessionStore
+{
+public:
+    // Storage type of a column
+    enum ColumnType : quint32 {
+        Int32 = 1,
+        Int64 = 2,
+        Float32 = 3,
+        Blob = 4
+    };
+
+    // Logical columns of the current schema
+    enum Column {
+        ColStart = 0, // Int64, ms since epoch
+        ColDuration,
+        ColAttempts,
+        ColCorrect,
+        ColWrong,
+        ColAccuracy,  // Float32
+        ColWpm,
+        ColTone,
+        ColMode,      // Blob
+        ColItems,     // Blob
+        ColCharBase   // 3 Int32 columns per tracked char: Total, OK, Err
+    };
+    // Schema 2: 2 Int32 columns per tracked char: latency count and sum (ms)
+    static constexpr int ColLatencyBase = ColCharBase + 3 * CharIndex::TrackedCount;
+    static constexpr int ColumnCount = ColLatencyBase + 2 * CharIndex::TrackedCount;
+    static constexpr quint32 SchemaVersion = 2;
+
+    // Column index of a tracked char counter (field: 0 = Total, 1 = OK, 2 = Err)
+    static int charColumn(int charId, int field) { return ColCharBase + 3 * charId + field; }
+    // Column index of a tracked char latency counter (field: 0 = count, 1 = sum)
+    static int latencyColumn(int charId, int field) { return ColLatencyBase + 2 * charId + field; }
+
+    explicit SessionStore(const QString &path = defaultFile());
+    ~SessionStore();
+
+    // Maps the store for reading (re-maps if it changed on disk)
+    bool open();
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+
+    // Number of committed rows
+    qint64 rowCount() const;
+
+    // Typed column access on the mapping; nullptr if the column is absent or of another type
+    const qint32 *int32Column(int column) const;
+    const qint64 *int64Column(int column) const;
+    const float *float32Column(int column) const;
+    QString blob(int column, qint64 row) const;
+
+    // Decodes a full row
+    SessionRecord row(qint64 index) const;
+
+    // Appends one session (creates the store if needed)
+    bool append(const SessionRecord &record);
+
+    // Upgrades a store written with an older schema; a no-op if it is current
+    bool migrate();
+
+    // Writes all rows to a CSV file in the legacy statistics.csv format
+    bool exportCsv(const QString &csvPath);
+
+    // Creates a store holding exactly these rows (replaces any existing file)
+    static bool writeStore(const QString &path, const QVector<SessionRecord> &records);
+
+    // Name of a column as written in the directory and in CSV headers
+    static QString columnName(int column);
+    // Logical column for a name, or -1 if unknown
+    static int columnForName(const QString &name);
+
+    static QString defaultFile() { return QStringLiteral("statistics.cws"); }
+    static QString legacyCsvFile() { return QStringLiteral("statistics.csv"); }
+
+private:
+    struct Header;
+    struct ColumnDesc;
+
+    const Header *header() const;
+    const uchar *columnData(int column, ColumnType type) const;
+    bool appendInPlace(const SessionRecord &record, bool &needsRewrite);
+    bool rewrite(quint64 extraRows, quint64 extraHeap);
+
+    QString m_path;
+    QFile m_file;
+    uchar *m_map = nullptr;
+    qint64 m_mapSize = 0;
+    QVector<int> m_columnSlots; // Logical column -> index in the file directory (-1 if absent)
+};
+
+#endif // SESSIONSTORE_H
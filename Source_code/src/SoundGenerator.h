@@ -6,8 +6,12 @@
 #include <QAudioSink>
 #include <QBuffer>
 #include <QByteArray>
+#include <QHash>
 #include <QMediaDevices>
 #include <QThread>
+#include <QVector>
+#include "MorseQueue.h"
+#include "MorseSynth.h"
 
 // The SoundGenerator class is responsible for generating and playing Morse code audio
 class SoundGenerator : public QObject
@@ -21,12 +25,23 @@ public:
     // Destructor: Cleans up resources
     ~SoundGenerator();
 
-    // Method to play a Morse code string with specified WPM (Words Per Minute) and frequency
-    // extraSpacingMs: Additional silence between characters (Farnsworth spacing)
     // Method to play a Morse code string with specified WPM (Words Per Minute) and frequency
     // extraSpacingMs: Additional silence between characters (Farnsworth spacing)
     void playMorse(const QString &text, int wpm, int toneHz, int extraSpacingMs = 0);
 
+    // Plays text after whatever is still playing (echo of decoded text).
+    // If more than MaxBacklogMs of audio is waiting, the oldest characters
+    // that have not started are skipped so the echo catches up.
+    // Does not change lastSchedule().
+    void appendMorse(const QString &text, int wpm, int toneHz, int extraSpacingMs = 0);
+    static constexpr int MaxBacklogMs = 2000;
+
+    // Per-character timing of the text passed to the last playMorse(), one entry per character
+    const QVector<CharTiming> &lastSchedule() const { return m_schedule; }
+
+    // Stops whatever is playing (without reporting playbackFinished)
+    void stop();
+
     // Real-Time Tone Control
     void startTone(int toneHz);
     void stopTone();
@@ -36,28 +51,48 @@ public:
 
     // Set the audio output device
     void setAudioDevice(const QAudioDevice &device);
+    // Set the output device by id (e.g. a remembered one). The outputs are
+    // only listed to find it when playback first starts; an id that is no
+    // longer present means the system default.
+    void setAudioDeviceId(const QByteArray &id);
+
+signals:
+    // The text of the last playMorse() (and anything appended) has been played completely
+    void playbackFinished();
 
 private:
-    // Helper method to generate the raw audio data for the entire text
-    QByteArray generateAudioData(const QString &text, int wpm, int toneHz, int extraSpacingMs);
-    
-    // Helper method to create a sine wave tone for a specific duration and frequency
-    QByteArray createTone(double durationS, int toneHz, int sampleRate);
-    
-    // Helper method to create silence (for spacing) for a specific duration
-    QByteArray createSilence(double durationS, int sampleRate);
+    // Replaces the audio sink with one playing from source
+    void startSink(QIODevice *source);
     
     // Pointer to the audio sink (output device interface)
     QAudioSink *m_audioSink;
     
-    // Buffer to hold audio data during playback
+    // Buffer to hold the sidetone during playback
     QBuffer *m_buffer;
+    // Queue the Morse text plays from
+    MorseQueue *m_queue;
     
     // Volume level (0.0 to 1.0)
     qreal m_volume = 1.0;
     
-    // Selected Audio Device
-    QAudioDevice m_device = QMediaDevices::defaultAudioOutput();
+    // Character timing of the current playback
+    QVector<CharTiming> m_schedule;
+    // A playMorse() text is playing (not a sidetone)
+    bool m_playingMorse = false;
+
+    // appendMorse() audio: the elements at the last speed, tone and spacing,
+    // and each character rendered from them
+    MorseSynth::Elements m_echoElements;
+    QHash<QChar, QByteArray> m_echoChars;
+    int m_echoWpm = -1;
+    int m_echoTone = -1;
+    int m_echoSpacing = -1;
+
+    // Selected Audio Device (null: the system default, looked up when playback starts,
+    // so constructing a SoundGenerator does not query the audio backend)
+    QAudioDevice m_device;
+    // Id of a device that has not been looked up yet (see setAudioDeviceId)
+    QByteArray m_deviceId;
 };
 
 #endif // SOUNDGENERATOR_H
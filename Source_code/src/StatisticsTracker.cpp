@@ -1,23 +1,101 @@
 #include "StatisticsTracker.h"
+#include "StatsIndex.h"
 #include <QFile>
-#include <QTextStream>
-#include <QDir>
-#include <algorithm>
-#include <vector>
+#include <QDebug>
+#include <QMap>
+#include <QSet>
 
 // Constructor for StatisticsTracker
 // Initializes the start time to now and counters to zero
 StatisticsTracker::StatisticsTracker()
-    : m_startTime(QDateTime::currentDateTime()), 
+    : StatisticsTracker(QDateTime::currentDateTime())
+{
+}
+
+// Constructor with an explicit session start time
+StatisticsTracker::StatisticsTracker(const QDateTime &startTime)
+    : m_startTime(startTime), 
       m_totalAttempts(0), m_correctCount(0), m_wrongCount(0), m_currentWpm(20)
 {
 }
 
+// Open the journal and mark the start of this session in it
+bool StatisticsTracker::openJournal(const QString &path)
+{
+    if (!m_journal.open(path)) return false;
+    m_journal.beginSession(m_startTime);
+    return true;
+}
+
+// Rebuild unsaved sessions from the journal, then compact it into the archive
+int StatisticsTracker::recoverJournal(const QString &journalPath, const QString &archivePath)
+{
+    if (!QFile::exists(journalPath)) return 0;
+
+    QVector<JournalRecord> records = AttemptJournal::read(journalPath);
+
+    // Group attempts by session (keyed by session start time)
+    QMap<qint64, QVector<JournalRecord>> sessions;
+    QSet<qint64> committed;
+    QVector<JournalRecord> attempts;
+    qint64 currentSession = 0;
+    for (const JournalRecord &r : records) {
+        switch (r.type) {
+        case JournalRecordType::SessionBegin:
+            currentSession = r.timestampMs;
+            break;
+        case JournalRecordType::Attempt:
+            sessions[currentSession].append(r);
+            attempts.append(r);
+            break;
+        case JournalRecordType::SessionEnd:
+            committed.insert(r.timestampMs);
+            break;
+        }
+    }
+
+    // Replay every session that was never written to the session store
+    int recovered = 0;
+    QVector<JournalRecord> ended;
+    for (auto it = sessions.constBegin(); it != sessions.constEnd(); ++it) {
+        if (committed.contains(it.key()) || it.value().isEmpty()) continue;
+
+        StatisticsTracker tracker(QDateTime::fromMSecsSinceEpoch(it.key()));
+        for (const JournalRecord &r : it.value()) {
+            tracker.setCurrentWpm(r.wpm);
+            tracker.recordAttempt(r.target, r.user);
+            for (const JournalLatency &l : r.latencies) {
+                if (l.charId < CharIndex::Size) tracker.m_charStats[l.charId].latency.add(l.ms);
+            }
+        }
+        tracker.m_endTime = QDateTime::fromMSecsSinceEpoch(it.value().last().timestampMs);
+        if (!tracker.saveSession(tracker.getCurrentWpm(), 0, "RECOVERED")) continue;
+        JournalRecord end;
+        end.type = JournalRecordType::SessionEnd;
+        end.timestampMs = it.key();
+        ended.append(end);
+        recovered++;
+    }
+
+    // Mark the recovered sessions as saved first: if the journal has to be
+    // kept below, the next start must not store them a second time
+    if (!ended.isEmpty() && !AttemptJournal::append(journalPath, ended)) {
+        qWarning() << "Could not mark recovered sessions in" << journalPath;
+    }
+
+    // Compact: keep the per-attempt history in the archive and start a fresh journal
+    if (attempts.isEmpty() || AttemptJournal::append(archivePath, attempts)) {
+        QFile::remove(journalPath);
+    }
+    return recovered;
+}
+
 // Record a user's attempt at typing the target string
 // target: The string the user was supposed to type
 // user: The string the user actually typed
 // Returns pair: <number of correct characters, length of target string>
-QPair<int, int> StatisticsTracker::recordAttempt(const QString &target, const QString &user)
+QPair<int, int> StatisticsTracker::recordAttempt(const QString &target, const QString &user,
+                                                 const AttemptTiming &timing)
 {
     // Normalize inputs: trim whitespace and convert to uppercase
     QString t = target.trimmed().toUpper();
@@ -30,240 +108,199 @@ QPair<int, int> StatisticsTracker::recordAttempt(const QString &target, const QS
     m_totalAttempts++;
     if (isCorrect) m_correctCount++; else m_wrongCount++;
     
-    // Update statistics for this specific word/item
-    m_itemStats[t].given++;
-    if (isCorrect) m_itemStats[t].correct++; else m_itemStats[t].wrong++;
+    // Update statistics for this specific word/item (single hash probe)
+    ItemStats &item = m_itemStats[t];
+    item.given++;
+    if (isCorrect) item.correct++; else item.wrong++;
     
-    // Update smart character-level statistics (handling alignment)
-    updateCharStatsSmart(t, u);
+    // Align the answer against the target once; the same alignment drives
+    // both the character statistics and the immediate feedback score
+    Alignment alignment = EditAligner::align(t, u);
+    updateCharStats(alignment);
+    const QVector<JournalLatency> latencies = updateLatency(alignment, timing);
     
-    // Calculate simple match count for immediate feedback using LCS (Longest Common Subsequence)
-    // This gives a score of how many characters were "correct" relative to the target sequence
-    
-    int n = t.length();
-    int m = u.length();
-    // Create DP table initialized to 0. Size (n+1) x (m+1)
-    std::vector<std::vector<int>> dp(n + 1, std::vector<int>(m + 1, 0));
-
-    // Fill DP table
-    for (int i = 1; i <= n; ++i) {
-        for (int j = 1; j <= m; ++j) {
-            // If characters match
-            if (t[i-1] == u[j-1]) {
-                dp[i][j] = dp[i-1][j-1] + 1;
-            } else {
-                // Take max of previous states (skip char in target OR skip char in user)
-                dp[i][j] = std::max(dp[i-1][j], dp[i][j-1]);
-            }
-        }
-    }
-    // Result is in the bottom-right cell
-    int matched = dp[n][m];
+    // Journal the attempt with its latencies so a crash does not lose them
+    if (m_journal.isOpen()) m_journal.appendAttempt(t, u, m_currentWpm, latencies);
     
     // Return the number of matched characters and the total expected length
-    return qMakePair(matched, n);
+    return qMakePair(alignment.matches, t.length());
 }
 
-// Smartly update character stats using LCS Backtracking
-// This allows us to know WHICH characters were typed correctly vs missed/wrong
-void StatisticsTracker::updateCharStatsSmart(const QString &target, const QString &user)
+// Update character stats from the alignment
+// This allows us to know WHICH characters were typed correctly, and for the
+// wrong ones whether they were substituted or dropped
+void StatisticsTracker::updateCharStats(const Alignment &alignment)
 {
-    int n = target.length();
-    int m = user.length();
-    // Create DP table for LCS
-    std::vector<std::vector<int>> dp(n + 1, std::vector<int>(m + 1, 0));
-
-    // Standard LCS algorithm
-    for (int i = 1; i <= n; ++i) {
-        for (int j = 1; j <= m; ++j) {
-            if (target[i-1] == user[j-1]) {
-                dp[i][j] = dp[i-1][j-1] + 1;
-            } else {
-                dp[i][j] = std::max(dp[i-1][j], dp[i][j-1]);
+    for (const AlignedPair &step : alignment.steps) {
+        if (step.op == EditOp::Insert) {
+            // Extra character typed by the user (spaces are not tracked)
+            if (step.typed != ' ') {
+                int typedId = CharIndex::id(step.typed);
+                m_charStats[typedId].inserted++;
+                m_confusion.record(CharIndex::Gap, typedId);
             }
+            continue;
         }
-    }
-    
-    // Backtrack from the end to find which specific characters in Target were matched
-    std::vector<bool> targetMatched(n, false);
-    int i = n, j = m;
-    while (i > 0 && j > 0) {
-        if (target[i-1] == user[j-1]) {
-            // Found a match (part of the LCS)
-            targetMatched[i-1] = true;
-            i--; j--;
-        } else if (dp[i-1][j] > dp[i][j-1]) {
-            // Moves up: Character in target was not matched (deletion/substitution)
-            i--;
-        } else {
-            // Moves left: Character in user was extra (insertion)
-            j--;
-        }
-    }
-    
-    // Iterate through original target string to update stats
-    for (int k = 0; k < n; ++k) {
-        QChar c = target[k];
+
+        QChar c = step.target;
         // Skip spaces for stats tracking
         if (c == ' ') continue;
-        
+
         // This character was "given" to the user
-        m_charStats[c].given++;
-        
-        if (targetMatched[k]) {
-            // It was part of the LCS, specifically matched
-            m_charStats[c].correct++;
-        } else {
-            // It was not matched
-            m_charStats[c].wrong++;
+        int id = CharIndex::id(c);
+        CharStats &stats = m_charStats[id];
+        stats.given++;
+
+        switch (step.op) {
+        case EditOp::Match:
+            stats.correct++;
+            m_confusion.record(id, id);
+            break;
+        case EditOp::Substitute:
+            stats.wrong++;
+            stats.substituted++;
+            m_confusion.record(id, CharIndex::id(step.typed));
+            break;
+        case EditOp::Delete:
+            stats.wrong++;
+            stats.omitted++;
+            m_confusion.record(id, CharIndex::Gap);
+            break;
+        default:
+            break;
         }
     }
 }
 
-// Save session statistics to a CSV file
-void StatisticsTracker::saveSession(int wpm, int tone, const QString &mode)
+// Save session statistics to the session store
+bool StatisticsTracker::saveSession(int wpm, int tone, const QString &mode)
 {
     // Don't save session if there were no attempts
     if (m_totalAttempts == 0) {
-        return;
+        return false;
     }
 
-    // List of characters we track stats for
-    QList<QChar> trackedChars = getTrackedChars();
-
-    // Check if we need to upgrade the file format (add missing columns)
-    QFile file("statistics.csv");
-    bool exists = file.exists();
-    bool needsUpgrade = false;
-
-    if (exists) {
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream in(&file);
-            QString header = in.readLine();
-            // Simple check: does the header contain detailed char stats?
-            if (!header.contains("A_Total")) {
-                needsUpgrade = true;
-            }
-            // Bug Fix: Check for malformed comma header from previous version
-            if (header.contains(",,_Total")) {
-               // We need to repair the file
-               file.close();
-               
-               // Read all content
-               if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-                   QString content = file.readAll();
-                   file.close();
-                   
-                   // Replace bad patterns
-                   content.replace(",,_Total", ",COMMA_Total");
-                   content.replace(",,_OK", ",COMMA_OK");
-                   content.replace(",,_Err", ",COMMA_Err");
-                   
-                   // Write back
-                   if (file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
-                       QTextStream outRewrite(&file);
-                       outRewrite << content;
-                       file.close();
-                       
-                       // File is now fixed, proceed as normal exists=true
-                   }
-               }
-            } else {
-               file.close();
-            }
-        }
+    SessionRecord record;
+    record.start = m_startTime;
+
+    // Calculate duration of session
+    QDateTime endTime = m_endTime.isValid() ? m_endTime : QDateTime::currentDateTime();
+    record.duration = qint32(m_startTime.secsTo(endTime));
+
+    record.attempts = m_totalAttempts;
+    record.correct = m_correctCount;
+    record.wrong = m_wrongCount;
+    // Calculate overall accuracy percentage
+    record.accuracy = float((double)m_correctCount / m_totalAttempts * 100.0);
+    record.wpm = wpm;
+    record.tone = tone;
+    record.mode = mode;
+
+    // Serialize item stats to a string
+    m_itemStats.forEach([&record](const QString &key, const ItemStats &item) {
+        record.items += QString("%1(G:%2/OK:%3/ERR:%4);").arg(key).arg(item.given).arg(item.correct).arg(item.wrong);
+    });
+
+    // Detailed character stats
+    // Tracked chars occupy the first ids, so this is a straight array walk
+    for (int id = 0; id < CharIndex::TrackedCount; ++id) {
+        const CharStats &stats = m_charStats[id];
+        record.chars[id].total = stats.given;
+        record.chars[id].ok = stats.correct;
+        record.chars[id].err = stats.wrong;
+        record.latency[id].count = stats.latency.count;
+        record.latency[id].totalMs = qint32(stats.latency.totalMs);
     }
 
-    if (needsUpgrade) {
-        // Renaming old file
-        QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
-        QString backupName = QString("statistics_backup_%1.csv").arg(timestamp);
-        QFile::rename("statistics.csv", backupName);
-        exists = false; // Treat as new file
+    // Append the row (a legacy statistics.csv is imported into the store at startup)
+    SessionStore store;
+    bool saved = store.append(record);
+    if (!saved) {
+        qWarning() << "Could not save session to" << SessionStore::defaultFile();
+    } else if (store.open()) {
+        // Fold the new row into the aggregate index and its rollups right away
+        StatsIndex index;
+        index.load();
+        if (index.sync(store)) index.save();
+        store.close();
     }
 
-    // Open the statistics file in Append mode
-    if (file.open(QIODevice::Append | QIODevice::Text)) {
-        QTextStream out(&file);
-
-        // Write header if file is new
-        if (!exists) {
-            out << "Date,Time,Duration,Attempts,Correct,Wrong,Accuracy,WPM,Tone,Mode,Item_Stats";
-            // Append headers for all tracked characters
-            for (QChar c : trackedChars) {
-                QString label = c;
-                if (c == ',') label = "COMMA";
-                out << "," << label << "_Total," << label << "_OK," << label << "_Err";
-            }
-            out << "\n";
-        }
+    // Fold this session's confusion counts into the all-time matrix
+    ConfusionMatrix history;
+    history.load(ConfusionMatrix::historyFile());
+    history.add(m_confusion);
+    history.save(ConfusionMatrix::historyFile());
 
-        // Calculate overall accuracy percentage
-        double acc = 0;
-        if (m_totalAttempts > 0) acc = (double)m_correctCount / m_totalAttempts * 100.0;
+    // Same for the latency distributions
+    LatencyTable latency;
+    latency.load(LatencyTable::historyFile());
+    for (int id = 0; id < CharIndex::Size; ++id) latency[id].merge(m_charStats[id].latency);
+    latency.save(LatencyTable::historyFile());
 
-        // Calculate duration of session
-        qint64 duration = m_startTime.secsTo(QDateTime::currentDateTime());
+    // The session is now in the store; recovery must not replay it again
+    // (if saving failed, the journal keeps it open so the next start retries)
+    if (saved && m_journal.isOpen()) m_journal.endSession(m_startTime);
+    return saved;
+}
 
-        // Serialize item stats to a string
-        QString itemStr;
-        for (auto it = m_itemStats.begin(); it != m_itemStats.end(); ++it) {
-            itemStr += QString("%1(G:%2/OK:%3/ERR:%4);").arg(it.key()).arg(it.value().given).arg(it.value().correct).arg(it.value().wrong);
-        }
+// Attribute recognition latency to correctly copied characters; returns
+// what was recorded, for the journal
+QVector<JournalLatency> StatisticsTracker::updateLatency(const Alignment &alignment, const AttemptTiming &timing)
+{
+    QVector<JournalLatency> recorded;
+    if (timing.keyMs.isEmpty()) return recorded;
 
-        // Write the CSV row - Standard Stats
-        out << m_startTime.toString("yyyy-MM-dd") << ","
-            << m_startTime.toString("HH:mm:ss") << ","
-            << duration << "," // Duration in seconds
-            << m_totalAttempts << ","
-            << m_correctCount << ","
-            << m_wrongCount << ","
-            << QString::number(acc, 'f', 1) << "," // Accuracy with 1 decimal place
-            << wpm << ","
-            << tone << ","
-            << mode << ","
-            << itemStr; // Detailed stats
-
-        // Write the CSV row - detailed character stats
-        for (QChar c : trackedChars) {
-            int total = m_charStats[c].given;
-            int ok = m_charStats[c].correct;
-            int err = m_charStats[c].wrong;
-            out << "," << total << "," << ok << "," << err;
-        }
+    for (const AlignedPair &step : alignment.steps) {
+        if (step.op != EditOp::Match || step.target == ' ') continue;
+        if (step.typedIndex >= timing.keyMs.size()) continue;
 
-        out << "\n";
+        // Reference point: end of the character's audio, or the previous key in TX mode
+        qint64 reference = 0;
+        if (!timing.cueEndMs.isEmpty()) {
+            if (step.targetIndex >= timing.cueEndMs.size()) continue;
+            reference = timing.cueEndMs[step.targetIndex];
+        } else {
+            reference = step.typedIndex > 0 ? timing.keyMs[step.typedIndex - 1] : timing.shownMs;
+        }
+        if (reference <= 0) continue;
 
-        file.close();
+        // Typing ahead of the audio counts as instant recognition
+        qint64 latency = qMax<qint64>(0, timing.keyMs[step.typedIndex] - reference);
+        JournalLatency sample;
+        sample.charId = quint8(CharIndex::id(step.target));
+        sample.ms = quint16(qMin<qint64>(latency, LatencyStats::MaxMs + 1));
+        m_charStats[sample.charId].latency.add(sample.ms);
+        recorded.append(sample);
     }
+    return recorded;
 }
 
 QList<QChar> StatisticsTracker::getTrackedChars()
 {
-    // Return A-Z, 0-9, and specific punctuation
+    // Return A-Z, 0-9, and specific punctuation (? . , / and = for BT, + for AR)
+    // These are the first CharIndex ids, in CSV column order
     QList<QChar> list;
-    // A-Z
-    for (char c = 'A'; c <= 'Z'; ++c) list.append(QChar(c));
-    // 0-9
-    for (char c = '0'; c <= '9'; ++c) list.append(QChar(c));
-    // Punctuation
-    list.append('?');
-    list.append('.');
-    list.append(',');
-    list.append('/');
-    list.append('='); // BT
-    list.append('+'); // AR (mapped often to +)
-
+    for (int id = 0; id < CharIndex::TrackedCount; ++id) list.append(CharIndex::charAt(id));
     return list;
 }
 
 // --- Accessors for Live Data ---
 
-QMap<QChar, CharStats> StatisticsTracker::getCharStats() const
+const CharStatsTable &StatisticsTracker::getCharStats() const
 {
     return m_charStats;
 }
 
+const ItemStatsTable &StatisticsTracker::getItemStats() const
+{
+    return m_itemStats;
+}
+
+const ConfusionMatrix &StatisticsTracker::getConfusionMatrix() const
+{
+    return m_confusion;
+}
+
 int StatisticsTracker::getTotalAttempts() const
 {
     return m_totalAttempts;
@@ -1,16 +1,28 @@
 #ifndef STATISTICSTRACKER_H
 #define STATISTICSTRACKER_H
 
-// Include standard Qt classes for string, map, and datetime handling
+// Include standard Qt classes for string, pair, and datetime handling
 #include <QString>
-#include <QMap>
+#include <QPair>
 #include <QDateTime>
+#include <QVector>
+#include <array>
+#include "EditAligner.h"
+#include "ConfusionMatrix.h"
+#include "FlatHashMap.h"
+#include "AttemptJournal.h"
+#include "SessionStore.h"
+#include "LatencyStats.h"
 
 // Structure to track statistics for an individual character
 struct CharStats {
     int given = 0;   // Number of times the character was presented
     int correct = 0; // Number of times it was typed correctly
     int wrong = 0;   // Number of times it was typed incorrectly
+    int substituted = 0; // Wrong copies where another character was typed instead
+    int omitted = 0;     // Wrong copies where the character was dropped entirely
+    int inserted = 0;    // Times this character was typed without being in the target
+    LatencyStats latency; // Recognition latency of the correct copies
 };
 
 // Structure to track statistics for a complete item (word or group)
@@ -20,25 +32,57 @@ struct ItemStats {
     int wrong = 0;   // Number of times it had errors
 };
 
+// Timestamps of one attempt (ms since epoch), used for recognition latency
+struct AttemptTiming {
+    QVector<qint64> cueEndMs; // Per target char: end of its audio (RX); empty in TX mode
+    QVector<qint64> keyMs;    // Per answer char: when it was typed or decoded
+    qint64 shownMs = 0;       // TX mode: when the target was shown
+};
+
+// Dense per-character stats, indexed by CharIndex id
+using CharStatsTable = std::array<CharStats, CharIndex::Size>;
+// Per-item stats keyed by the item text
+using ItemStatsTable = FlatHashMap<ItemStats>;
+
 // Class responsible for tracking user performance statistics
 class StatisticsTracker
 {
 public:
     // Constructor: Initializes the tracker
     StatisticsTracker();
+    // Constructor for a session that started at a known time (journal recovery)
+    explicit StatisticsTracker(const QDateTime &startTime);
+
+    // Starts journaling every attempt of this session to the write-ahead journal
+    bool openJournal(const QString &path = AttemptJournal::defaultFile());
+
+    // Replays the journal left by previous runs: sessions that never reached
+    // saveSession (crash, power loss) are rebuilt, saved and marked as ended in
+    // the journal, then all attempts are compacted into the attempt archive and
+    // the journal is cleared (kept if the archive cannot be written).
+    // Returns the number of recovered sessions.
+    static int recoverJournal(const QString &journalPath = AttemptJournal::defaultFile(),
+                              const QString &archivePath = AttemptJournal::archiveFile());
     
     // Records a training attempt comparing the target string vs user input
-    // Returns a pair containing <number_of_matched_chars, total_target_chars>
-    QPair<int, int> recordAttempt(const QString &target, const QString &user);
+    // timing (optional) adds the recognition latency of every correctly copied character
+    // Returns a pair containing <number_of_matched_chars, total_target_chars>.
+    // Matched characters are the Match steps of the minimum-edit alignment with
+    // the most matches, so a swapped pair or a dropped character keeps them.
+    QPair<int, int> recordAttempt(const QString &target, const QString &user,
+                                  const AttemptTiming &timing = AttemptTiming());
     
-    // Saves the current session statistics to a CSV file
-    void saveSession(int wpm, int tone, const QString &mode);
+    // Saves the current session statistics to the session store.
+    // Returns false if there was nothing to save or the store could not be written.
+    bool saveSession(int wpm, int tone, const QString &mode);
 
     // Returns the list of characters tracked for statistics
     static QList<QChar> getTrackedChars();
 
-    // Accessors for Live Data
-    QMap<QChar, CharStats> getCharStats() const;
+    // Accessors for Live Data (read-only views, no copies)
+    const CharStatsTable &getCharStats() const;
+    const ItemStatsTable &getItemStats() const;
+    const ConfusionMatrix &getConfusionMatrix() const;
     int getTotalAttempts() const;
     int getCorrectCount() const;
     QDateTime getStartTime() const;
@@ -50,6 +94,8 @@ public:
 private:
     // Timestamp when the session started
     QDateTime m_startTime;
+    // Timestamp when the session ended (only set for recovered sessions; otherwise "now")
+    QDateTime m_endTime;
     // Counter for total attempts made in this session
     int m_totalAttempts;
     // Counter for total correct attempts (perfect matches)
@@ -59,15 +105,21 @@ private:
     // Current WPM setting for the session
     int m_currentWpm;
     
-    // Map storing stats per character (e.g., 'A', 'B', '1')
-    QMap<QChar, CharStats> m_charStats;
-    // Map storing stats per specific item/word
-    QMap<QString, ItemStats> m_itemStats;
+    // Stats per character (e.g., 'A', 'B', '1'), indexed by CharIndex id
+    CharStatsTable m_charStats;
+    // Stats per specific item/word
+    ItemStatsTable m_itemStats;
+    // Target x typed character counts for this session
+    ConfusionMatrix m_confusion;
+    // Write-ahead log of this session's attempts
+    AttemptJournal m_journal;
     
-    // Helper method to calculate Diff/LCS (Longest Common Subsequence)
-    // Used to intelligently attribute correct/wrong stats to individual characters 
-    // even when there are insertions/deletions/misalignments
-    void updateCharStatsSmart(const QString &target, const QString &user);
+    // Attributes correct/wrong stats to individual characters from an edit-distance
+    // alignment, classifying each error as substitution, omission or insertion
+    void updateCharStats(const Alignment &alignment);
+    // Latency of each matched character: answer keystroke minus the end of its
+    // audio (RX), or minus the previous keystroke / target display (TX)
+    QVector<JournalLatency> updateLatency(const Alignment &alignment, const AttemptTiming &timing);
 };
 
 #endif // STATISTICSTRACKER_H
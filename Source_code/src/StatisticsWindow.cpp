@@ -1,27 +1,244 @@
 #include "StatisticsWindow.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QFile>
-#include <QTextStream>
 #include <QPainter>
 #include <QMap>
 #include <algorithm>
 #include <QDebug>
 #include <QDate>
-#include "StatisticsTracker.h" // for getTrackedChars
+#include <QPushButton>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <cmath>
+#include "StatisticsTracker.h"
+#include "SessionStore.h"
 
 // --- TrendChart Implementation ---
 
+namespace {
+// Largest-triangle-three-buckets: picks about `threshold` of the points in
+// [first, last] that keep the visual shape of the series (x = point index).
+// The first and last points are always kept.
+template <typename YFn>
+QVector<int> decimate(int first, int last, int threshold, YFn y)
+{
+    QVector<int> out;
+    const int count = last - first + 1;
+    if (count <= 0) return out;
+    if (threshold >= count || threshold < 3) {
+        out.reserve(count);
+        for (int i = first; i <= last; ++i) out.append(i);
+        return out;
+    }
+
+    out.reserve(threshold);
+    out.append(first);
+    const double every = double(count - 2) / (threshold - 2);
+    int a = first; // Previously selected point
+    for (int b = 0; b < threshold - 2; ++b) {
+        // Average of the next bucket is the third corner of the triangle
+        int avgStart = first + int(std::floor((b + 1) * every)) + 1;
+        int avgEnd = qMin(first + int(std::floor((b + 2) * every)) + 1, last + 1);
+        double avgX = 0, avgY = 0;
+        for (int i = avgStart; i < avgEnd; ++i) {
+            avgX += i;
+            avgY += y(i);
+        }
+        int avgCount = qMax(1, avgEnd - avgStart);
+        avgX /= avgCount;
+        avgY /= avgCount;
+
+        // Point of this bucket with the largest triangle area
+        int rangeStart = first + int(std::floor(b * every)) + 1;
+        int rangeEnd = first + int(std::floor((b + 1) * every)) + 1;
+        double ay = y(a);
+        double maxArea = -1;
+        int chosen = rangeStart;
+        for (int i = rangeStart; i < rangeEnd; ++i) {
+            double area = std::abs((a - avgX) * (y(i) - ay) - (a - i) * (avgY - ay));
+            if (area > maxArea) {
+                maxArea = area;
+                chosen = i;
+            }
+        }
+        out.append(chosen);
+        a = chosen;
+    }
+    out.append(last);
+    return out;
+}
+
+// Rounds a WPM axis maximum up to the nearest 10 (at least 50)
+int wpmScale(int wpm)
+{
+    return ((qMax(50, wpm) + 9) / 10) * 10;
+}
+}
+
 TrendChart::TrendChart(QWidget *parent) : QWidget(parent)
 {
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     setMinimumHeight(250);
 }
 
-void TrendChart::setData(const QList<SessionData> &data)
+void TrendChart::setData(const QList<SessionData> &overview, const QList<SessionData> &sessions, int detailLimit)
 {
-    m_data = data;
-    update(); // Trigger repaint
+    m_overview = overview;
+    // Session detail only adds something if the overview is coarser
+    const bool detail = detailLimit > 0 && sessions.size() > overview.size();
+    m_sessions = detail ? sessions : QList<SessionData>();
+    m_detailLimit = detail ? detailLimit : 0;
+    if (!detail) m_detail = false;
+    // Appended sessions leave the indices of a zoomed-in detail view valid
+    m_data = m_detail ? m_sessions : m_overview;
+
+    // Axis scale over the whole history, so zooming and panning keep it stable
+    int maxWpm = m_hasLive ? m_live.wpm : 0;
+    for (const SessionData &s : m_overview) maxWpm = qMax(maxWpm, s.wpm);
+    for (const SessionData &s : m_sessions) maxWpm = qMax(maxWpm, s.wpm);
+    m_maxWpm = wpmScale(maxWpm);
+
+    m_pathsValid = false;
+    setView(m_zoomed ? m_viewFirst : 0, m_zoomed ? m_viewLast : pointCount() - 1);
+}
+
+void TrendChart::setLiveSession(const SessionData &session)
+{
+    bool added = !m_hasLive;
+    m_live = session;
+    m_hasLive = true;
+    if (wpmScale(session.wpm) > m_maxWpm) {
+        m_maxWpm = wpmScale(session.wpm);
+        m_pathsValid = false;
+    }
+    // A new last point widens the full view; otherwise only the live point moves
+    if (added && !m_zoomed) setView(0, pointCount() - 1);
+    else update();
+}
+
+void TrendChart::clearLiveSession()
+{
+    if (!m_hasLive) return;
+    m_hasLive = false;
+    setView(m_zoomed ? m_viewFirst : 0, m_zoomed ? m_viewLast : pointCount() - 1);
+}
+
+QRectF TrendChart::plotRect() const
+{
+    // Margins
+    const int padL = 40;
+    const int padR = 40;
+    const int padT = 20;
+    const int padB = 30;
+    return QRectF(padL, padT, width() - padL - padR, height() - padT - padB);
+}
+
+double TrendChart::xFor(double index, const QRectF &plot) const
+{
+    double span = m_viewLast - m_viewFirst;
+    if (span <= 0) return plot.center().x();
+    return plot.left() + (index - m_viewFirst) / span * plot.width();
+}
+
+void TrendChart::setView(double first, double last)
+{
+    if (m_detailLimit > 0) {
+        if (m_detail) leaveDetail(first, last);
+        else enterDetail(first, last);
+    }
+
+    const double maxIndex = qMax(0, pointCount() - 1);
+    // Never zoom in closer than a handful of points
+    double span = qBound(qMin(4.0, maxIndex), last - first, maxIndex);
+    first = qBound(0.0, first, maxIndex - span);
+
+    if (first != m_viewFirst || first + span != m_viewLast) m_pathsValid = false;
+    m_viewFirst = first;
+    m_viewLast = first + span;
+    m_zoomed = span < maxIndex;
+    update();
+}
+
+namespace {
+// First session at or after t
+int sessionAt(const QList<SessionData> &sessions, const QDateTime &t)
+{
+    auto it = std::lower_bound(sessions.cbegin(), sessions.cend(), t,
+                               [](const SessionData &s, const QDateTime &time) { return s.dateTime < time; });
+    return int(it - sessions.cbegin());
+}
+
+// Overview point (bucket) that contains t
+int bucketAt(const QList<SessionData> &overview, const QDateTime &t)
+{
+    auto it = std::upper_bound(overview.cbegin(), overview.cend(), t,
+                               [](const QDateTime &time, const SessionData &s) { return time < s.dateTime; });
+    return qMax(0, int(it - overview.cbegin()) - 1);
+}
+}
+
+void TrendChart::enterDetail(double &first, double &last)
+{
+    const int n = m_overview.size();
+    if (n == 0) return;
+    const int lo = qBound(0, int(std::floor(first)), n - 1);
+    const int hi = qBound(0, int(std::ceil(last)), n - 1);
+
+    // Sessions inside the visible buckets
+    const int a = sessionAt(m_sessions, m_overview[lo].dateTime);
+    const int b = hi + 1 < n ? sessionAt(m_sessions, m_overview[hi + 1].dateTime) : m_sessions.size();
+    if (b - a > m_detailLimit || b - a < 2) return;
+
+    m_detail = true;
+    m_data = m_sessions;
+    m_pathsValid = false;
+    first = a;
+    // The live point stays in view if it was
+    last = last >= n ? m_sessions.size() : b - 1;
+}
+
+void TrendChart::leaveDetail(double &first, double &last)
+{
+    if (last - first + 1 <= m_detailLimit) return;
+    const int n = m_sessions.size();
+    const int lo = qBound(0, int(std::floor(first)), n - 1);
+    const int hi = qBound(0, int(std::ceil(last)), n - 1);
+
+    m_detail = false;
+    m_data = m_overview;
+    m_pathsValid = false;
+    first = bucketAt(m_overview, m_sessions[lo].dateTime);
+    last = last >= n ? m_overview.size() : bucketAt(m_overview, m_sessions[hi].dateTime);
+}
+
+void TrendChart::rebuildPaths()
+{
+    m_accPath = QPainterPath();
+    m_wpmPath = QPainterPath();
+    m_pathSize = size();
+    m_pathsValid = true;
+    if (m_data.isEmpty()) return;
+
+    const QRectF plot = plotRect();
+    // Visible history plus one neighbour on each side, so lines reach the edges
+    int first = qMax(0, int(std::floor(m_viewFirst)) - 1);
+    int last = qMin(int(m_data.size()) - 1, int(std::ceil(m_viewLast)) + 1);
+    if (first > last) return;
+
+    // About one vertex per two pixels is indistinguishable from all of them
+    const int threshold = qMax(3, int(plot.width() / 2));
+    auto accY = [&](int i) { return plot.bottom() - m_data[i].accuracy / 100.0 * plot.height(); };
+    auto wpmY = [&](int i) { return plot.bottom() - double(m_data[i].wpm) / m_maxWpm * plot.height(); };
+
+    const QVector<int> acc = decimate(first, last, threshold, accY);
+    m_accPath.moveTo(xFor(acc[0], plot), accY(acc[0]));
+    for (int k = 1; k < acc.size(); ++k) m_accPath.lineTo(xFor(acc[k], plot), accY(acc[k]));
+
+    const QVector<int> wpm = decimate(first, last, threshold, wpmY);
+    m_wpmPath.moveTo(xFor(wpm[0], plot), wpmY(wpm[0]));
+    for (int k = 1; k < wpm.size(); ++k) m_wpmPath.lineTo(xFor(wpm[k], plot), wpmY(wpm[k]));
 }
 
 void TrendChart::paintEvent(QPaintEvent *event)
@@ -32,15 +249,12 @@ void TrendChart::paintEvent(QPaintEvent *event)
 
     int w = width();
     int h = height();
-
-    // Margins
-    int padL = 40;
-    int padR = 40;
-    int padT = 20;
-    int padB = 30;
-
-    int plotW = w - padL - padR;
-    int plotH = h - padT - padB;
+    const QRectF plot = plotRect();
+    int padL = int(plot.left());
+    int padR = w - int(plot.right());
+    int padT = int(plot.top());
+    int padB = h - int(plot.bottom());
+    int plotH = int(plot.height());
 
     // Draw Background
     painter.fillRect(rect(), Qt::white);
@@ -67,67 +281,59 @@ void TrendChart::paintEvent(QPaintEvent *event)
         painter.drawText(QRect(0, y - 10, padL - 5, 20), Qt::AlignRight | Qt::AlignVCenter, QString::number(i * 25));
     }
 
-    if (m_data.isEmpty()) {
+    int numPts = pointCount();
+    if (numPts == 0) {
         painter.setPen(Qt::gray);
         painter.drawText(rect(), Qt::AlignCenter, "No Data Available");
         return;
     }
 
-    // Determine Axis Scales
-    int maxWpm = 50; // Default min max
-    for (const auto &d : m_data) {
-        if (d.wpm > maxWpm) maxWpm = d.wpm;
-    }
-    // Round up to nearest 10
-    maxWpm = ((maxWpm + 9) / 10) * 10;
-
     // Draw WPM Labels
     for (int i = 0; i < 5; ++i) {
         int y = (h - padB) - (i * plotH / 4);
-        int wpmVal = i * maxWpm / 4;
+        int wpmVal = i * m_maxWpm / 4;
         painter.drawText(QRect(w - padR + 5, y - 10, padR, 20), Qt::AlignLeft | Qt::AlignVCenter, QString::number(wpmVal));
     }
 
-    // Plot Data
-    int numPts = m_data.size();
-    if (numPts < 2) {
-         // If only one point, draw it in the middle
-         // ... (simplified for now)
-    }
-    
-    double xStep = (numPts > 1) ? (double)plotW / (numPts - 1) : plotW / 2;
+    // Decimated history lines, rebuilt only when data, view or size changed
+    if (!m_pathsValid || m_pathSize != size()) rebuildPaths();
 
-    QPolygonF accPoints;
-    QPolygonF wpmPoints;
+    painter.save();
+    painter.setClipRect(plot.adjusted(-4, -4, 4, 4));
+    painter.setBrush(Qt::NoBrush);
+    painter.setPen(QPen(QColor("#28a745"), 2));
+    painter.drawPath(m_accPath);
+    painter.setPen(QPen(QColor("#0055aa"), 2));
+    painter.drawPath(m_wpmPath);
+
+    auto accY = [&](const SessionData &s) { return plot.bottom() - s.accuracy / 100.0 * plot.height(); };
+    auto wpmY = [&](const SessionData &s) { return plot.bottom() - double(s.wpm) / m_maxWpm * plot.height(); };
+
+    // The live point joins the last history point
+    if (m_hasLive && !m_data.isEmpty()) {
+        int last = m_data.size() - 1;
+        double x0 = xFor(last, plot);
+        double x1 = xFor(numPts - 1, plot);
+        painter.setPen(QPen(QColor("#28a745"), 2));
+        painter.drawLine(QPointF(x0, accY(m_data[last])), QPointF(x1, accY(m_live)));
+        painter.setPen(QPen(QColor("#0055aa"), 2));
+        painter.drawLine(QPointF(x0, wpmY(m_data[last])), QPointF(x1, wpmY(m_live)));
+    }
 
-    for (int i = 0; i < numPts; ++i) {
-        double x = padL + (i * xStep);
-        
-        // Accumulate points
-        // Acc (0-100)
-        double yAcc = (h - padB) - (m_data[i].accuracy / 100.0 * plotH);
-        accPoints << QPointF(x, yAcc);
-
-        // WPM (0-maxWpm)
-        double yWpm = (h - padB) - ((double)m_data[i].wpm / maxWpm * plotH);
-        wpmPoints << QPointF(x, yWpm);
-        
-        // Draw Dots
-        painter.setBrush(QColor("#28a745")); // Green
+    // Dots only while individual points are distinguishable
+    int first = qMax(0, int(std::floor(m_viewFirst)));
+    int last = qMin(numPts - 1, int(std::ceil(m_viewLast)));
+    if ((last - first + 1) * 6 <= plot.width()) {
         painter.setPen(Qt::NoPen);
-        painter.drawEllipse(QPointF(x, yAcc), 3, 3);
-        
-        painter.setBrush(QColor("#0055aa")); // Blue
-        painter.drawEllipse(QPointF(x, yWpm), 3, 3);
+        for (int i = first; i <= last; ++i) {
+            double x = xFor(i, plot);
+            painter.setBrush(QColor("#28a745")); // Green
+            painter.drawEllipse(QPointF(x, accY(point(i))), 3, 3);
+            painter.setBrush(QColor("#0055aa")); // Blue
+            painter.drawEllipse(QPointF(x, wpmY(point(i))), 3, 3);
+        }
     }
-    
-    // Draw Lines
-    painter.setPen(QPen(QColor("#28a745"), 2));
-    painter.setBrush(Qt::NoBrush);
-    if (accPoints.size() > 1) painter.drawPolyline(accPoints);
-    
-    painter.setPen(QPen(QColor("#0055aa"), 2));
-    if (wpmPoints.size() > 1) painter.drawPolyline(wpmPoints);
+    painter.restore();
 
     // Legend
     painter.setFont(QFont("Arial", 8, QFont::Bold));
@@ -136,6 +342,65 @@ void TrendChart::paintEvent(QPaintEvent *event)
     
     painter.setPen(QColor("#0055aa"));
     painter.drawText(padL + 90, padT, "WPM");
+
+    if (m_zoomed) {
+        painter.setFont(QFont("Arial", 8));
+        painter.setPen(Qt::gray);
+        painter.drawText(QRect(padL, 0, int(plot.width()) - 5, padT), Qt::AlignRight | Qt::AlignVCenter,
+                         QString("%1-%2 of %3 (double-click to reset)").arg(first + 1).arg(last + 1).arg(numPts));
+    }
+}
+
+void TrendChart::resizeEvent(QResizeEvent *event)
+{
+    m_pathsValid = false;
+    QWidget::resizeEvent(event);
+}
+
+void TrendChart::wheelEvent(QWheelEvent *event)
+{
+    if (pointCount() < 3 || event->angleDelta().y() == 0) return;
+
+    // Zoom around the point under the cursor
+    const QRectF plot = plotRect();
+    double fraction = qBound(0.0, (event->position().x() - plot.left()) / plot.width(), 1.0);
+    double anchor = m_viewFirst + fraction * (m_viewLast - m_viewFirst);
+    double factor = event->angleDelta().y() > 0 ? 0.8 : 1.25;
+    setView(anchor - (anchor - m_viewFirst) * factor, anchor + (m_viewLast - anchor) * factor);
+    event->accept();
+}
+
+void TrendChart::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && m_zoomed) {
+        m_dragX = event->position().x();
+        setCursor(Qt::ClosedHandCursor);
+    }
+}
+
+void TrendChart::mouseMoveEvent(QMouseEvent *event)
+{
+    if (m_dragX < 0) return;
+
+    // Pan by the dragged distance, converted to point indices
+    double span = m_viewLast - m_viewFirst;
+    double shift = -(event->position().x() - m_dragX) / plotRect().width() * span;
+    m_dragX = event->position().x();
+    setView(m_viewFirst + shift, m_viewLast + shift);
+}
+
+void TrendChart::mouseReleaseEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    m_dragX = -1;
+    unsetCursor();
+}
+
+void TrendChart::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    m_zoomed = false;
+    setView(0, pointCount() - 1);
 }
 
 // --- ProblemCharChart Implementation ---
@@ -207,21 +472,138 @@ void ProblemCharChart::paintEvent(QPaintEvent *event)
     }
 }
 
+// --- ConfusionHeatmap Implementation ---
+
+ConfusionHeatmap::ConfusionHeatmap(QWidget *parent) : QWidget(parent)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    setMinimumHeight(200);
+}
+
+void ConfusionHeatmap::setMatrix(const ConfusionMatrix &matrix)
+{
+    m_matrix = matrix;
+
+    // Work out which rows/columns carry data so the grid stays compact
+    const int dim = ConfusionMatrix::Dim;
+    QVector<bool> colUsed(dim, false);
+    m_rows.clear();
+    m_rowMax.clear();
+    for (int r = 0; r < dim; ++r) {
+        quint32 total = 0;
+        quint32 maxCell = 0;
+        for (int c = 0; c < dim; ++c) {
+            quint32 v = m_matrix.at(r, c);
+            if (!v) continue;
+            total += v;
+            maxCell = qMax(maxCell, v);
+            colUsed[c] = true;
+        }
+        if (!total) continue;
+        m_rows.append(r);
+        // Target rows are shaded by share of the row; the insertion row has
+        // no meaningful total, so it is shaded relative to its largest cell
+        m_rowMax.append(r == CharIndex::Gap ? maxCell : total);
+    }
+    m_cols.clear();
+    for (int c = 0; c < dim; ++c) {
+        if (colUsed[c]) m_cols.append(c);
+    }
+    update();
+}
+
+void ConfusionHeatmap::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+
+    int padL = 30;
+    int padT = 40;
+
+    painter.fillRect(rect(), Qt::white);
+
+    // Title
+    painter.setPen(Qt::black);
+    painter.setFont(QFont("Arial", 10, QFont::Bold));
+    painter.drawText(rect(), Qt::AlignTop | Qt::AlignHCenter, "Confusions (Target rows / Typed columns)");
+
+    if (m_rows.isEmpty()) {
+        painter.setPen(Qt::gray);
+        painter.drawText(rect(), Qt::AlignCenter, "No Data Available");
+        return;
+    }
+
+    double cellW = (double)(width() - padL - 5) / m_cols.size();
+    double cellH = (double)(height() - padT - 5) / m_rows.size();
+
+    // Helper for axis labels (',' is shown as-is here, unlike in CSV headers)
+    auto labelFor = [](int id) {
+        return id < CharIndex::Count ? QString(CharIndex::charAt(id)) : CharIndex::label(id);
+    };
+
+    painter.setFont(QFont("Arial", 7));
+    for (int ci = 0; ci < m_cols.size(); ++ci) {
+        painter.drawText(QRectF(padL + ci * cellW, padT - 15, cellW, 15), Qt::AlignCenter, labelFor(m_cols[ci]));
+    }
+
+    for (int ri = 0; ri < m_rows.size(); ++ri) {
+        int r = m_rows[ri];
+        double y = padT + ri * cellH;
+        painter.setPen(Qt::black);
+        painter.drawText(QRectF(0, y, padL - 5, cellH), Qt::AlignRight | Qt::AlignVCenter, labelFor(r));
+
+        for (int ci = 0; ci < m_cols.size(); ++ci) {
+            int c = m_cols[ci];
+            quint32 v = m_matrix.at(r, c);
+            if (!v) continue;
+            double rate = (double)v / m_rowMax[ri];
+            // Correct copies in green, every kind of error in red
+            QColor color = (r == c) ? QColor("#28a745") : QColor("#dc3545");
+            color.setAlphaF(0.15 + 0.85 * rate);
+            painter.fillRect(QRectF(padL + ci * cellW, y, cellW - 1, cellH - 1), color);
+        }
+    }
+}
+
 // --- StatisticsWindow Implementation ---
 
+// Above this many sessions the full trend range is drawn from day/week/month
+// buckets; a range zoomed in to at most this many sessions shows each of them
+static const int kMaxTrendPoints = 400;
+
 StatisticsWindow::StatisticsWindow(StatisticsTracker *tracker, QWidget *parent) 
     : QDialog(parent), m_tracker(tracker)
 {
     setWindowTitle("Session Statistics");
-    resize(600, 500);
+    resize(800, 550);
     
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     
     m_trendChart = new TrendChart(this);
     m_problemChart = new ProblemCharChart(this);
+    m_heatmap = new ConfusionHeatmap(this);
     
     mainLayout->addWidget(m_trendChart, 2); // 2/3 height
-    mainLayout->addWidget(m_problemChart, 1); // 1/3 height
+    
+    // Problem chars and confusion heatmap side by side
+    QHBoxLayout *charLayout = new QHBoxLayout();
+    charLayout->addWidget(m_problemChart, 1);
+    charLayout->addWidget(m_heatmap, 1);
+    mainLayout->addLayout(charLayout, 1); // 1/3 height
+    
+    // Export the binary store in the legacy CSV format
+    QHBoxLayout *btnLayout = new QHBoxLayout();
+    btnLayout->addStretch();
+    QPushButton *btnExport = new QPushButton("Export CSV...");
+    connect(btnExport, &QPushButton::clicked, this, &StatisticsWindow::exportCsv);
+    btnLayout->addWidget(btnExport);
+    mainLayout->addLayout(btnLayout);
+    
+    // The all-time matrix only changes when a session is saved, so read it once
+    m_historyConfusion.load(ConfusionMatrix::historyFile());
+    
+    // Aggregates from previous runs; the first refresh only reads newer rows
+    m_index.load();
     
     // Load Data immediately
     refreshData();
@@ -229,104 +611,52 @@ StatisticsWindow::StatisticsWindow(StatisticsTracker *tracker, QWidget *parent)
 
 void StatisticsWindow::refreshData()
 {
-    loadCsvData();
+    // History only reaches the chart when it actually changed
+    if (syncHistory() || !m_historyShown) {
+        // Very long histories are drawn from the rollups
+        m_trendChart->setData(m_index.trend(kMaxTrendPoints), m_index.sessions(), kMaxTrendPoints);
+        m_historyShown = true;
+    }
     // Merge live data on top
     mergeLiveData();
     
-    m_trendChart->setData(m_sessions);
     m_problemChart->setData(m_problemChars);
+    
+    // Heatmap = history + live session; a fixed-size array add, no file access
+    m_confusion = m_historyConfusion;
+    if (m_tracker) m_confusion.add(m_tracker->getConfusionMatrix());
+    m_heatmap->setMatrix(m_confusion);
 }
 
-void StatisticsWindow::loadCsvData()
+bool StatisticsWindow::syncHistory()
 {
-    m_sessions.clear();
-    m_problemChars.clear();
+    // Mapping the store is O(1); only rows appended since the last sync are read.
+    // A store that cannot be opened is synced as empty, so a removed history
+    // does not linger in the index.
+    SessionStore store;
+    store.open();
     
-    QFile file("statistics.csv");
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return;
-    
-    QTextStream in(&file);
-    QString headerLine = in.readLine();
-    QStringList headers = headerLine.split(",");
-    
-    int idxDate = -1; // Date column is sometimes separate or we assume ISO format
-    int idxTime = -1; // Time column
-    // Actually the code writes Date,Time,Duration...
-    // Let's find indices dynamically
-    int idxAcc = headers.indexOf("Accuracy");
-    int idxWpm = headers.indexOf("WPM");
-    
-    // Map for char stats: char -> {idxTotal, idxErr}
-    QMap<QString, QPair<int, int>> charCols;
-    
-    for (int i = 0; i < headers.size(); ++i) {
-        QString h = headers[i];
-        if (h.endsWith("_Total")) {
-            QString c = h.left(h.length() - 6);
-            if (c == "COMMA") c = ",";
-            if (!charCols.contains(c)) charCols[c] = qMakePair(-1, -1);
-            charCols[c].first = i;
-        } else if (h.endsWith("_Err")) {
-             QString c = h.left(h.length() - 4);
-             if (c == "COMMA") c = ",";
-             if (!charCols.contains(c)) charCols[c] = qMakePair(-1, -1);
-             charCols[c].second = i;
-        }
-    }
-    
-    // Map to accumulate global char stats
-    // Map to accumulate global char stats
-    m_globalCharStats.clear(); // Reset global stats
-    QMap<QChar, QPair<int, int>> globalCharStats; // Local var for accumulation before transferring to member
-
+    if (!m_index.sync(store)) return false;
+    m_index.save();
+    return true;
+}
 
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        QStringList parts = line.split(",");
-        if (parts.size() < headers.size()) continue; // Skip malformed lines
-        
-        // Parse Session
-        SessionData s;
-        // Parse Date/Time (cols 0 and 1)
-        // Assume format yyyy-MM-dd HH:mm:ss
-        QString dtStr = parts[0] + " " + parts[1];
-        s.dateTime = QDateTime::fromString(dtStr, "yyyy-MM-dd HH:mm:ss");
-        
-        bool ok;
-        if (idxWpm != -1) s.wpm = parts[idxWpm].toInt(&ok); else s.wpm = 0;
-        if (idxAcc != -1) s.accuracy = parts[idxAcc].toDouble(&ok); else s.accuracy = 0;
-        
-        m_sessions.append(s);
-        
-        // Accumulate Char Stats
-        auto it = charCols.constBegin();
-        while (it != charCols.constEnd()) {
-            QChar c = it.key()[0];
-            int idxT = it.value().first;
-            int idxE = it.value().second;
-            
-            if (idxT != -1 && idxE != -1 && idxT < parts.size() && idxE < parts.size()) {
-                int t = parts[idxT].toInt();
-                int e = parts[idxE].toInt();
-                
-                if (!globalCharStats.contains(c)) globalCharStats[c] = qMakePair(0, 0);
-                globalCharStats[c].first += t;
-                globalCharStats[c].second += e;
-            }
-            ++it;
-        }
-    }
-    file.close();
+void StatisticsWindow::exportCsv()
+{
+    QString path = QFileDialog::getSaveFileName(this, "Export Statistics", "statistics_export.csv", "CSV Files (*.csv)");
+    if (path.isEmpty()) return;
     
-    // Store accumulated CSV stats into member
-    m_globalCharStats = globalCharStats;
+    SessionStore store;
+    if (!store.exportCsv(path)) {
+        QMessageBox::warning(this, "Export", "Could not export statistics to " + path);
+    }
 }
 
 void StatisticsWindow::mergeLiveData()
 {
     if (!m_tracker) return;
     
-    // 1. Add Current Session to Session List (Trend Chart)
+    // 1. Show Current Session as the live point of the Trend Chart
     int attempts = m_tracker->getTotalAttempts();
     if (attempts > 0) {
         SessionData s;
@@ -337,31 +667,30 @@ void StatisticsWindow::mergeLiveData()
         s.accuracy = (double)correct / attempts * 100.0;
         s.duration = s.dateTime.secsTo(QDateTime::currentDateTime());
         
-        m_sessions.append(s);
+        m_trendChart->setLiveSession(s);
+    } else {
+        m_trendChart->clearLiveSession();
     }
     
-    // 2. Merge Character Stats (Problem Chart)
-    QMap<QChar, CharStats> liveStats = m_tracker->getCharStats();
+    // 2. Merge Character Stats (Problem Chart): indexed history + the tracker's live array
+    const CharStatsTable &liveStats = m_tracker->getCharStats();
+    const auto &history = m_index.charTotals();
     
-    for (auto it = liveStats.begin(); it != liveStats.end(); ++it) {
-        QChar c = it.key();
-        int total = it.value().given;
-        int err = it.value().wrong;
-        
-        if (!m_globalCharStats.contains(c)) m_globalCharStats[c] = qMakePair(0, 0);
-        m_globalCharStats[c].first += total;
-        m_globalCharStats[c].second += err;
+    for (int id = 0; id < CharIndex::Count; ++id) {
+        m_globalCharStats[id] = id < CharIndex::TrackedCount ? history[id] : CharTotals();
+        m_globalCharStats[id].total += liveStats[id].given;
+        m_globalCharStats[id].err += liveStats[id].wrong;
     }
     
     // Re-calculate problem chars from merged data
     m_problemChars.clear();
-    for (auto it = m_globalCharStats.constBegin(); it != m_globalCharStats.constEnd(); ++it) {
-        int total = it.value().first;
-        int err = it.value().second;
+    for (int id = 0; id < CharIndex::Count; ++id) {
+        qint64 total = m_globalCharStats[id].total;
+        qint64 err = m_globalCharStats[id].err;
         if (total > 0 && err > 0) { // Only count if there are errors
             CharErrorData data;
-            data.character = it.key();
-            data.totalAttempts = total;
+            data.character = CharIndex::charAt(id);
+            data.totalAttempts = int(total);
             data.errorRate = (double)err / total * 100.0;
             m_problemChars.append(data);
         }
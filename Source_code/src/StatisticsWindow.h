@@ -6,14 +6,11 @@
 #include <QList>
 #include <QDateTime>
 #include <QMap>
-
-// Structure to hold data for a single session
-struct SessionData {
-    QDateTime dateTime;
-    int wpm;
-    double accuracy;
-    int duration;
-};
+#include <QVector>
+#include <QPainterPath>
+#include <array>
+#include "ConfusionMatrix.h"
+#include "StatsIndex.h"
 
 // Structure to hold error rate for a character
 struct CharErrorData {
@@ -23,18 +20,67 @@ struct CharErrorData {
 };
 
 // Widget for drawing the Trend Chart (WPM and Accuracy)
+// Lines are decimated (largest-triangle-three-buckets) to about one point per
+// two pixels of the visible range and cached as painter paths, so repaints do
+// not walk the whole history. The wheel zooms the session axis around the
+// cursor, dragging pans, and a double-click shows everything again.
+// Long histories are shown from an overview (day/week/month buckets); once
+// the view is zoomed in to at most detailLimit sessions it switches to the
+// individual sessions of that range, and back when zoomed out again.
 class TrendChart : public QWidget
 {
     Q_OBJECT
 public:
     explicit TrendChart(QWidget *parent = nullptr);
-    void setData(const QList<SessionData> &data);
+    // overview: the points of the full range. sessions (optional): every
+    // session, in time order, for ranges of at most detailLimit of them.
+    void setData(const QList<SessionData> &overview, const QList<SessionData> &sessions = {}, int detailLimit = 0);
+    // The running session is drawn as an extra last point, kept apart from
+    // the history so live updates never copy the session list
+    void setLiveSession(const SessionData &session);
+    void clearLiveSession();
 
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
 
 private:
-    QList<SessionData> m_data;
+    int pointCount() const { return m_data.size() + (m_hasLive ? 1 : 0); }
+    const SessionData &point(int i) const { return i < m_data.size() ? m_data[i] : m_live; }
+    QRectF plotRect() const;
+    double xFor(double index, const QRectF &plot) const;
+    void setView(double first, double last);
+    // Convert a requested view between overview and session indices when it
+    // crosses detailLimit sessions
+    void enterDetail(double &first, double &last);
+    void leaveDetail(double &first, double &last);
+    void rebuildPaths(); // Decimates the visible history into m_accPath/m_wpmPath
+
+    QList<SessionData> m_data;     // Points drawn: m_overview or m_sessions
+    QList<SessionData> m_overview;
+    QList<SessionData> m_sessions;  // Empty if the overview already is per session
+    int m_detailLimit = 0;
+    bool m_detail = false;          // m_data holds m_sessions
+    SessionData m_live;
+    bool m_hasLive = false;
+    int m_maxWpm = 50;        // Right axis scale, fixed per data set so panning does not rescale
+
+    // Visible range in point indices; m_zoomed = false follows the whole history
+    double m_viewFirst = 0;
+    double m_viewLast = 0;
+    bool m_zoomed = false;
+    double m_dragX = -1;      // Last mouse x while panning, -1 when not dragging
+
+    // Decimated history, valid for m_pathSize and the current view
+    QPainterPath m_accPath;
+    QPainterPath m_wpmPath;
+    QSize m_pathSize;
+    bool m_pathsValid = false;
 };
 
 // Widget for drawing the Problem Characters Bar Chart
@@ -52,6 +98,24 @@ private:
     QList<CharErrorData> m_data;
 };
 
+// Widget for drawing the character confusion heatmap (target x typed)
+class ConfusionHeatmap : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit ConfusionHeatmap(QWidget *parent = nullptr);
+    void setMatrix(const ConfusionMatrix &matrix);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    ConfusionMatrix m_matrix;
+    QVector<int> m_rows;       // Target ids that have data, in display order
+    QVector<int> m_cols;       // Typed ids that have data, in display order
+    QVector<quint32> m_rowMax; // Normalizer per displayed row
+};
+
 // Main Window for Statistics
 class StatisticsTracker; // Forward Declaration
 
@@ -60,20 +124,31 @@ class StatisticsWindow : public QDialog
     Q_OBJECT
 public:
     explicit StatisticsWindow(StatisticsTracker *tracker, QWidget *parent = nullptr);
-    void refreshData(); // Reloads data from CSV AND current live session
+    void refreshData(); // Reloads data from the session store AND current live session
+
+private slots:
+    void exportCsv(); // Writes the session store out as CSV
 
 private:
-    void loadCsvData();
+    bool syncHistory(); // Folds new session store rows into the index; true if anything changed
     void mergeLiveData(); // Helper to merge live stats
     
     TrendChart *m_trendChart;
     ProblemCharChart *m_problemChart;
+    ConfusionHeatmap *m_heatmap;
     
-    QList<SessionData> m_sessions;
     QList<CharErrorData> m_problemChars;
     
-    // Internal accumulator for all stats (historical + live)
-    QMap<QChar, QPair<int, int>> m_globalCharStats; // <Total, Err>
+    // Persisted aggregates over the session store (history only)
+    StatsIndex m_index;
+    bool m_historyShown = false; // Trend chart holds the current history
+    
+    // Internal accumulator for all stats (historical + live), indexed by CharIndex id
+    std::array<CharTotals, CharIndex::Size> m_globalCharStats;
+    
+    // All-time confusion counts, loaded once; live session counts are added on refresh
+    ConfusionMatrix m_historyConfusion;
+    ConfusionMatrix m_confusion;
     
     StatisticsTracker *m_tracker; // Reference to live tracker
 };
@@ -0,0 +1,148 @@
+#include "StatsIndex.h"
+#include "SessionStore.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+
+namespace {
+// File header: magic "CWIX" and format version
+const quint32 kMagic = 0x58495743;
+const quint32 kVersion = 2; // 2: rollups
+}
+
+StatsIndex::StatsIndex(const QString &path) : m_path(path)
+{
+    reset();
+}
+
+void StatsIndex::reset()
+{
+    m_rowsIngested = 0;
+    m_lastStartMs = 0;
+    m_sessions.clear();
+    m_charTotals.fill(CharTotals());
+    m_rollups.clear();
+}
+
+bool StatsIndex::load()
+{
+    reset();
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setByteOrder(QDataStream::LittleEndian);
+    quint32 magic = 0, version = 0, charCount = 0;
+    qint64 sessionCount = 0;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion) return false;
+
+    in >> m_rowsIngested >> m_lastStartMs >> charCount;
+    if (charCount != quint32(CharIndex::TrackedCount)) { reset(); return false; }
+    for (CharTotals &t : m_charTotals) in >> t.total >> t.err;
+
+    in >> sessionCount;
+    if (sessionCount < 0 || sessionCount != m_rowsIngested) { reset(); return false; }
+    m_sessions.reserve(int(sessionCount));
+    for (qint64 i = 0; i < sessionCount && in.status() == QDataStream::Ok; ++i) {
+        qint64 ms;
+        qint32 wpm, duration;
+        double accuracy;
+        in >> ms >> wpm >> accuracy >> duration;
+        SessionData s;
+        s.dateTime = QDateTime::fromMSecsSinceEpoch(ms);
+        s.wpm = wpm;
+        s.accuracy = accuracy;
+        s.duration = duration;
+        m_sessions.append(s);
+    }
+
+    if (in.status() != QDataStream::Ok || !m_rollups.read(in)) {
+        reset();
+        return false;
+    }
+    return true;
+}
+
+bool StatsIndex::save() const
+{
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << kMagic << kVersion << m_rowsIngested << m_lastStartMs << quint32(CharIndex::TrackedCount);
+    for (const CharTotals &t : m_charTotals) out << t.total << t.err;
+
+    out << qint64(m_sessions.size());
+    for (const SessionData &s : m_sessions) {
+        out << qint64(s.dateTime.toMSecsSinceEpoch()) << qint32(s.wpm) << s.accuracy << qint32(s.duration);
+    }
+    m_rollups.write(out);
+    return file.commit();
+}
+
+bool StatsIndex::sync(const SessionStore &store)
+{
+    qint64 rows = store.rowCount();
+    const qint64 *start = store.int64Column(SessionStore::ColStart);
+
+    // The store was rebuilt, replaced (e.g. re-import) or removed: start over
+    bool changed = false;
+    if (m_rowsIngested > rows ||
+        (m_rowsIngested > 0 && (!start || start[m_rowsIngested - 1] != m_lastStartMs))) {
+        reset();
+        changed = true;
+    }
+    if (m_rowsIngested == rows) return changed;
+
+    const qint32 *wpm = store.int32Column(SessionStore::ColWpm);
+    const float *acc = store.float32Column(SessionStore::ColAccuracy);
+    const qint32 *duration = store.int32Column(SessionStore::ColDuration);
+
+    // Only the new tail of each column is touched
+    for (qint64 i = m_rowsIngested; i < rows; ++i) {
+        SessionData s;
+        s.dateTime = start ? QDateTime::fromMSecsSinceEpoch(start[i]) : QDateTime();
+        s.wpm = wpm ? wpm[i] : 0;
+        s.accuracy = acc ? acc[i] : 0;
+        s.duration = duration ? duration[i] : 0;
+        m_sessions.append(s);
+    }
+    for (int id = 0; id < CharIndex::TrackedCount; ++id) {
+        const qint32 *total = store.int32Column(SessionStore::charColumn(id, 0));
+        const qint32 *err = store.int32Column(SessionStore::charColumn(id, 2));
+        for (qint64 i = m_rowsIngested; i < rows; ++i) {
+            if (total) m_charTotals[id].total += total[i];
+            if (err) m_charTotals[id].err += err[i];
+        }
+    }
+
+    for (qint64 i = m_rowsIngested; i < rows; ++i) m_rollups.add(store.row(i));
+
+    m_rowsIngested = rows;
+    m_lastStartMs = start ? start[rows - 1] : 0;
+    return true;
+}
+
+QList<SessionData> StatsIndex::trend(int maxPoints) const
+{
+    if (m_sessions.size() <= maxPoints) return m_sessions;
+
+    const QDate from = m_sessions.first().dateTime.date();
+    const QDate to = m_sessions.last().dateTime.date();
+    const RollupPeriod period = m_rollups.periodFor(from, to, maxPoints);
+
+    QList<SessionData> points;
+    const QVector<RollupBucket> buckets = m_rollups.range(period, from, to);
+    points.reserve(buckets.size());
+    for (const RollupBucket &b : buckets) {
+        SessionData s;
+        s.dateTime = QDateTime(b.start, QTime(0, 0));
+        s.wpm = qRound(b.averageWpm());
+        s.accuracy = b.accuracy();
+        s.duration = int(b.duration);
+        points.append(s);
+    }
+    return points;
+}
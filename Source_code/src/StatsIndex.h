@@ -0,0 +1,70 @@
+#ifndef STATSINDEX_H
+#define STATSINDEX_H
+
+// Include standard Qt classes for strings, dates and containers
+#include <QString>
+#include <QDateTime>
+#include <QList>
+#include <array>
+#include "CharIndex.h"
+#include "TrendRollups.h"
+
+class SessionStore;
+
+// Structure to hold data for a single session
+struct SessionData {
+    QDateTime dateTime;
+    int wpm = 0;
+    double accuracy = 0;
+    int duration = 0;
+};
+
+// All-time counters for one character
+struct CharTotals {
+    qint64 total = 0; // Times given
+    qint64 err = 0;   // Times missed
+};
+
+// Persisted aggregate index over the session store (statistics.idx).
+// Holds everything the statistics window needs (per-session summaries,
+// per-character totals and day/week/month rollups) plus the number of store rows already folded in, so
+// a refresh only reads rows appended since the last one.
+class StatsIndex
+{
+public:
+    explicit StatsIndex(const QString &path = defaultFile());
+
+    // Reads the index from disk; starts empty if missing or invalid
+    bool load();
+    // Writes the index to disk atomically
+    bool save() const;
+
+    // Folds rows appended to the store since the last sync into the aggregates.
+    // Rebuilds from scratch if the store was replaced underneath us; a store
+    // that is not open counts as empty. Returns true if the aggregates changed
+    // (reset or rows ingested), i.e. the index needs saving and redrawing.
+    bool sync(const SessionStore &store);
+
+    const QList<SessionData> &sessions() const { return m_sessions; }
+    const std::array<CharTotals, CharIndex::TrackedCount> &charTotals() const { return m_charTotals; }
+    const TrendRollups &rollups() const { return m_rollups; }
+
+    // Trend points for the whole history: one per session while there are at
+    // most maxPoints sessions, otherwise one per day, week or month bucket
+    QList<SessionData> trend(int maxPoints) const;
+    qint64 rowsIngested() const { return m_rowsIngested; }
+
+    static QString defaultFile() { return QStringLiteral("statistics.idx"); }
+
+private:
+    void reset();
+
+    QString m_path;
+    qint64 m_rowsIngested = 0; // Store rows already folded in
+    qint64 m_lastStartMs = 0;  // Start time of the last ingested row (detects a replaced store)
+    QList<SessionData> m_sessions;
+    std::array<CharTotals, CharIndex::TrackedCount> m_charTotals;
+    TrendRollups m_rollups;
+};
+
+#endif // STATSINDEX_H
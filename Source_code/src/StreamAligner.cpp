@@ -0,0 +1,102 @@
+#include "StreamAligner.h"
+#include "EditAligner.h"
+
+void StreamAligner::reset()
+{
+    m_target.clear();
+    m_cue.clear();
+    m_typed.clear();
+    m_keys.clear();
+}
+
+void StreamAligner::appendTarget(const QString &text, const QVector<qint64> &cueEndMs)
+{
+    m_target += text.toUpper();
+    for (int i = 0; i < text.size(); ++i) m_cue.append(i < cueEndMs.size() ? cueEndMs[i] : 0);
+}
+
+void StreamAligner::appendTyped(const QString &text, qint64 nowMs)
+{
+    m_typed += text.toUpper();
+    for (int i = 0; i < text.size(); ++i) m_keys.append(nowMs);
+}
+
+bool StreamAligner::removeTyped(int count)
+{
+    int n = qMin(count, int(m_typed.size()));
+    m_typed.chop(n);
+    m_keys.resize(m_typed.size());
+    return n == count;
+}
+
+QVector<StreamSegment> StreamAligner::commit(qint64 nowMs, bool final)
+{
+    QVector<StreamSegment> out;
+    if (m_target.isEmpty()) {
+        // Typing without anything played is not scored
+        if (final) reset();
+        return out;
+    }
+
+    Alignment alignment = EditAligner::align(m_target, m_typed);
+    const QVector<AlignedPair> &steps = alignment.steps;
+
+    // Typed characters consumed up to and including each step
+    QVector<int> consumed(steps.size());
+    int used = 0;
+    for (int s = 0; s < steps.size(); ++s) {
+        if (steps[s].typedIndex >= 0) used = steps[s].typedIndex + 1;
+        consumed[s] = used;
+    }
+
+    // Group boundaries (target spaces) whose alignment is settled. Boundaries
+    // further back are settled too, so the settled ones form a prefix.
+    const int forcedBefore = m_target.size() - MaxWindow / 2;
+    QVector<int> boundaries;
+    for (int s = 0; s < steps.size(); ++s) {
+        const AlignedPair &step = steps[s];
+        if (step.op == EditOp::Insert || step.target != ' ') continue;
+        bool settled = final
+            || m_typed.size() - consumed[s] >= Horizon
+            || nowMs - m_cue[step.targetIndex] >= TimeoutMs
+            || (m_target.size() > MaxWindow && step.targetIndex < forcedBefore);
+        if (!settled) break;
+        boundaries.append(s);
+    }
+    if (boundaries.isEmpty() && !final) return out;
+
+    auto emitSegment = [&](int tStart, int tEnd, int uStart, int uEnd) {
+        if (tEnd <= tStart) return; // Leading or doubled space
+        StreamSegment seg;
+        seg.target = m_target.mid(tStart, tEnd - tStart);
+        seg.cueEndMs = m_cue.mid(tStart, tEnd - tStart);
+        // Typed text trimmed like a regular answer, keeping its timestamps aligned
+        while (uStart < uEnd && m_typed[uStart].isSpace()) ++uStart;
+        while (uEnd > uStart && m_typed[uEnd - 1].isSpace()) --uEnd;
+        seg.typed = m_typed.mid(uStart, uEnd - uStart);
+        seg.keyMs = m_keys.mid(uStart, uEnd - uStart);
+        out.append(seg);
+    };
+
+    int tStart = 0;
+    int uStart = 0;
+    for (int s : boundaries) {
+        int tEnd = steps[s].targetIndex;
+        int uEnd = consumed[s];
+        emitSegment(tStart, tEnd, uStart, uEnd);
+        tStart = tEnd + 1;
+        uStart = uEnd;
+    }
+    if (final) {
+        emitSegment(tStart, m_target.size(), uStart, m_typed.size());
+        reset();
+        return out;
+    }
+
+    // Drop the scored part of the window
+    m_target.remove(0, tStart);
+    m_cue.remove(0, tStart);
+    m_typed.remove(0, uStart);
+    m_keys.remove(0, uStart);
+    return out;
+}
@@ -0,0 +1,55 @@
+#ifndef STREAMALIGNER_H
+#define STREAMALIGNER_H
+
+// Include standard Qt classes for strings and containers
+#include <QString>
+#include <QVector>
+
+// One scored group of a continuous copy stream: a target group and what was
+// typed for it, with the timestamps the latency statistics need
+struct StreamSegment {
+    QString target;          // Group without spaces
+    QString typed;           // Typed text aligned to it (trimmed, uppercase)
+    QVector<qint64> cueEndMs; // Per target character: end of its audio
+    QVector<qint64> keyMs;    // Per typed character: when it was typed
+};
+
+// Incremental alignment of a continuous copy stream.
+// The played text and the typed text are appended as they happen; only the
+// part not yet scored is buffered. commit() aligns that window with
+// EditAligner and hands out the groups whose alignment can no longer change:
+// groups followed by enough typed characters, groups heard so long ago that
+// the user has moved on, and (on the final call) everything. Committed text is
+// dropped from the window, so every character is scored exactly once and the
+// cost per call stays bounded by the window size, however long the stream runs.
+class StreamAligner
+{
+public:
+    static constexpr int Horizon = 6;            // Typed characters needed after a group boundary
+    static constexpr qint64 TimeoutMs = 5000;    // Groups heard this long ago are scored anyway
+    static constexpr int MaxWindow = 256;        // Target characters buffered at most
+
+    void reset();
+
+    // Played text and the end of each character's audio (one entry per character)
+    void appendTarget(const QString &text, const QVector<qint64> &cueEndMs);
+    // Typed characters at nowMs
+    void appendTyped(const QString &text, qint64 nowMs);
+    // Removes the last count uncommitted typed characters (backspace).
+    // Returns false if some of them were already scored.
+    bool removeTyped(int count);
+
+    // Scores the groups that are settled; final scores everything buffered
+    QVector<StreamSegment> commit(qint64 nowMs, bool final = false);
+
+    int pendingTarget() const { return m_target.size(); }
+    int pendingTyped() const { return m_typed.size(); }
+
+private:
+    QString m_target;        // Unscored played text (uppercase)
+    QVector<qint64> m_cue;
+    QString m_typed;         // Unscored typed text (uppercase)
+    QVector<qint64> m_keys;
+};
+
+#endif // STREAMALIGNER_H
@@ -0,0 +1,146 @@
+#include "TrainerEngine.h"
+#include "MorseUtils.h"
+#include "LegacyCsvLoader.h"
+#include "SessionStore.h"
+#include <QRandomGenerator>
+#include <QDateTime>
+#include <algorithm>
+
+TrainerEngine::TrainerEngine()
+    : m_sampler(&m_tracker)
+{
+}
+
+void TrainerEngine::load(bool persist)
+{
+    m_persist = persist;
+    if (persist) {
+        // Convert legacy statistics CSV files into the session store (first run only)
+        LegacyCsvLoader::importIntoStore();
+        // Bring a store written by an older version up to the current schema
+        SessionStore().migrate();
+    }
+    // Koch lesson reached in previous sessions
+    m_koch.load();
+    if (persist) {
+        // Recover sessions lost by a crash in a previous run, then journal this one
+        StatisticsTracker::recoverJournal();
+        m_tracker.openJournal();
+    }
+    // Word lists: the built-in words plus any files in the words folder
+    m_corpus.addWords(MorseUtils::getTrainingWords());
+    m_corpus.loadDirectory();
+    // Review schedule: the cached cards plus the attempts archived since;
+    // only corpus words can come back as drills, so only they get item cards
+    m_reviews.setItemFilter([this](const QString &item) { return m_corpus.contains(item); });
+    m_reviews.loadHistory(AttemptJournal::archiveFile(), ReviewDeck::cacheFile(), persist);
+    // Plain text model (trained lazily on first use)
+    m_textModel.trainDirectory();
+}
+
+// Generate a target string for the drill
+QString TrainerEngine::generateTarget(const DrillSettings &settings)
+{
+    const int len = settings.groupSize;
+    const QString allowedText = settings.allowedChars.toUpper();
+
+    if (settings.mode == DrillMode::Koch) {
+        // Koch Mode: groups over the characters unlocked so far
+        if (settings.adaptive) {
+            m_sampler.setAlphabet(m_koch.activeChars());
+            return withDueReviews(settings, m_sampler.group(len), m_koch.activeChars());
+        }
+        return withDueReviews(settings, m_koch.generateGroup(len), m_koch.activeChars());
+    }
+    
+    if (settings.mode == DrillMode::Qso) {
+        // Callsigns / QSO Mode: on-air style text (needs the full alphabet)
+        return m_qso.generate(settings.qsoKind);
+    }
+    
+    if (settings.mode == DrillMode::Text) {
+        // Plain Text Mode: groupSize words of generated text over the allowed characters
+        quint64 allowed = allowedText.isEmpty() ? ~quint64(0) : WordCorpus::maskFor(allowedText);
+        QString text = m_textModel.generate(settings.textLevel, len, allowed);
+        if (!text.isEmpty()) return text;
+        // No training text (or nothing fits the allowed characters): random group
+    }
+    
+    if (settings.mode == DrillMode::Words) {
+        // Words Mode: a word from the corpus that only uses the allowed characters
+        quint64 allowed = allowedText.isEmpty() ? ~quint64(0) : WordCorpus::maskFor(allowedText);
+        // A word whose review is due takes precedence
+        if (settings.review) {
+            const QStringList due = m_reviews.items().due(1, QDateTime::currentMSecsSinceEpoch(),
+                [this, allowed](const QString &w) {
+                    return (WordCorpus::maskFor(w) & ~allowed) == 0 && m_corpus.contains(w);
+                });
+            if (!due.isEmpty()) return due.first();
+        }
+        QString word = m_corpus.draw(allowed);
+        if (!word.isEmpty()) return word;
+        // No word fits the allowed characters: fall back to a random group
+    }
+    
+    // Random Characters Mode
+    QString allowed = allowedText;
+    if (allowed.isEmpty()) allowed = "PARIS"; // Fallback
+    
+    // Adaptive: draw in proportion to error rate and latency (O(1) per char)
+    if (settings.adaptive) {
+        m_sampler.setAlphabet(allowed);
+        return withDueReviews(settings, m_sampler.group(len), allowed);
+    }
+    
+    QString res = "";
+    for (int i=0; i<len; ++i) {
+        int idx = QRandomGenerator::global()->bounded(allowed.length());
+        res.append(allowed[idx]);
+    }
+    return withDueReviews(settings, res, allowed);
+}
+
+QString TrainerEngine::withDueReviews(const DrillSettings &settings, QString group, const QString &alphabet)
+{
+    if (!settings.review || group.isEmpty()) return group;
+    const QStringList due = m_reviews.characters().due(qMax(1, group.length() / 2), QDateTime::currentMSecsSinceEpoch(),
+        [&alphabet](const QString &c) { return alphabet.contains(c); });
+    if (due.isEmpty()) return group;
+    for (int i = 0; i < due.size(); ++i) group[i] = due[i][0];
+    std::shuffle(group.begin(), group.end(), *QRandomGenerator::global());
+    return group;
+}
+
+// Record one attempt everywhere it counts: session stats, adaptive weights,
+// review schedule and Koch window
+AttemptResult TrainerEngine::scoreAttempt(const DrillSettings &settings, const QString &target,
+                                          const QString &answer, const AttemptTiming &timing)
+{
+    AttemptResult result;
+    QPair<int, int> score = m_tracker.recordAttempt(target, answer, timing);
+    result.matched = score.first;
+    result.total = score.second;
+    result.correct = answerMatches(settings, target, answer);
+    // The character weights depend on the stats just updated
+    m_sampler.invalidate();
+    // Reschedule the item and its characters
+    m_reviews.recordAttempt(target, answer, QDateTime::currentMSecsSinceEpoch());
+    
+    // Koch progression: score the lesson window, unlock the next character at 90%
+    if (settings.mode == DrillMode::Koch) {
+        result.unlocked = m_koch.recordAttempt(target, answer);
+        if (m_persist) m_koch.save();
+    }
+    return result;
+}
+
+bool TrainerEngine::answerMatches(const DrillSettings &settings, QString target, QString answer)
+{
+    target = target.trimmed().toUpper();
+    answer = answer.trimmed().toUpper();
+    if (settings.ignoreSpacing) {
+        answer.replace(" ", "");
+        target.replace(" ", "");
+    }
+    return answer == target;
+}
@@ -0,0 +1,88 @@
+#ifndef TRAINERENGINE_H
+#define TRAINERENGINE_H
+
+// Include standard Qt classes for strings
+#include <QString>
+#include "StatisticsTracker.h"
+#include "AdaptiveSampler.h"
+#include "KochEngine.h"
+#include "ReviewScheduler.h"
+#include "WordCorpus.h"
+#include "QsoGenerator.h"
+#include "MarkovTextGenerator.h"
+
+// What the drill is made of
+enum class DrillMode { Random, Words, Koch, Qso, Text };
+
+// Trainer settings, as read from the configuration card (or the command line)
+struct DrillSettings {
+    DrillMode mode = DrillMode::Random;
+    int groupSize = 5;               // Characters per group (words for plain text)
+    QString allowedChars;            // Random / Words / Text; empty = everything
+    bool adaptive = false;           // Weight characters by error rate and latency
+    bool review = false;             // Mix in due spaced-repetition reviews
+    bool ignoreSpacing = false;      // Spaces do not count when checking
+    QsoKind qsoKind = QsoKind::Callsign;
+    MarkovTextGenerator::Level textLevel = MarkovTextGenerator::Level::Character;
+};
+
+// Outcome of one scored attempt
+struct AttemptResult {
+    bool correct = false;  // The whole answer matched
+    bool unlocked = false; // A Koch character was unlocked
+    int matched = 0;       // Target characters copied correctly (aligned matches)
+    int total = 0;         // Target characters
+};
+
+// The trainer without a user interface: drill generation, scoring, session
+// statistics, Koch progression and the review schedule. The main window and
+// the command-line front end both drive one of these; nothing in here knows
+// about widgets, devices or audio output.
+class TrainerEngine
+{
+public:
+    TrainerEngine();
+    // The sampler points into the engine, so it stays where it was made
+    TrainerEngine(const TrainerEngine &) = delete;
+    TrainerEngine &operator=(const TrainerEngine &) = delete;
+
+    // Loads the persisted state (statistics store, Koch lesson, review history,
+    // word lists and training text). persist: import and migrate the store,
+    // recover crashed sessions, journal this one and save the Koch lesson after
+    // every attempt, as the interactive front ends do. Without it the engine
+    // only reads what is on disk.
+    void load(bool persist = true);
+
+    // Next drill target for the given settings
+    QString generateTarget(const DrillSettings &settings);
+    // Records an attempt in the stats, sampler, reviews and (Koch mode) the
+    // lesson window, which is saved right away when the engine persists
+    AttemptResult scoreAttempt(const DrillSettings &settings, const QString &target,
+                               const QString &answer, const AttemptTiming &timing = AttemptTiming());
+    // Whether an answer counts as correct (honours ignoreSpacing)
+    static bool answerMatches(const DrillSettings &settings, QString target, QString answer);
+
+    // Saves this session to the statistics store
+    void saveSession(int wpm, int tone, const QString &mode) { m_tracker.saveSession(wpm, tone, mode); }
+
+    StatisticsTracker *tracker() { return &m_tracker; }
+    const KochEngine &koch() const { return m_koch; }
+    KochEngine &koch() { return m_koch; }
+    const ReviewDeck &reviews() const { return m_reviews; }
+    const WordCorpus &corpus() const { return m_corpus; }
+
+private:
+    // Replaces up to half of a group with characters whose review is due
+    QString withDueReviews(const DrillSettings &settings, QString group, const QString &alphabet);
+
+    StatisticsTracker m_tracker; // Session stats (and journal)
+    AdaptiveSampler m_sampler;   // Weighted character draws for adaptive random groups
+    KochEngine m_koch;           // Koch lesson progression (persisted)
+    ReviewDeck m_reviews;        // SM-2 review schedule for characters and words
+    WordCorpus m_corpus;         // Word lists for the words drill, indexed by character set
+    QsoGenerator m_qso;          // Callsign and QSO text generator
+    MarkovTextGenerator m_textModel; // N-gram text generator for head-copy practice
+    bool m_persist = true;       // Write state back to disk (see load)
+};
+
+#endif // TRAINERENGINE_H
@@ -0,0 +1,122 @@
+#include "TrendRollups.h"
+#include "SessionStore.h"
+#include <algorithm>
+
+QDate TrendRollups::periodStart(RollupPeriod period, const QDate &date)
+{
+    switch (period) {
+    case RollupPeriod::Week: return date.addDays(1 - date.dayOfWeek());
+    case RollupPeriod::Month: return QDate(date.year(), date.month(), 1);
+    default: return date;
+    }
+}
+
+void TrendRollups::add(const SessionRecord &record)
+{
+    const QDate day = record.start.date();
+    if (!day.isValid()) return;
+
+    for (int p = 0; p < PeriodCount; ++p) {
+        QVector<RollupBucket> &series = m_series[p];
+        const QDate start = periodStart(RollupPeriod(p), day);
+
+        // Sessions arrive in time order, so this is almost always the last bucket
+        RollupBucket *bucket = nullptr;
+        if (!series.isEmpty() && series.last().start == start) {
+            bucket = &series.last();
+        } else {
+            auto it = std::lower_bound(series.begin(), series.end(), start,
+                                       [](const RollupBucket &b, const QDate &d) { return b.start < d; });
+            if (it == series.end() || it->start != start) {
+                RollupBucket fresh;
+                fresh.start = start;
+                it = series.insert(it, fresh);
+            }
+            bucket = &*it;
+        }
+
+        bucket->sessions++;
+        bucket->attempts += record.attempts;
+        bucket->correct += record.correct;
+        bucket->duration += record.duration;
+        bucket->wpmSum += record.wpm;
+        for (int id = 0; id < CharIndex::TrackedCount; ++id) {
+            bucket->charTotal[id] += record.chars[id].total;
+            bucket->charErr[id] += record.chars[id].err;
+        }
+    }
+}
+
+void TrendRollups::clear()
+{
+    for (QVector<RollupBucket> &series : m_series) series.clear();
+}
+
+const QVector<RollupBucket> &TrendRollups::series(RollupPeriod period) const
+{
+    return m_series[int(period)];
+}
+
+std::pair<int, int> TrendRollups::bounds(RollupPeriod period, const QDate &from, const QDate &to) const
+{
+    const QVector<RollupBucket> &s = m_series[int(period)];
+    auto less = [](const RollupBucket &b, const QDate &d) { return b.start < d; };
+    auto first = std::lower_bound(s.begin(), s.end(), from, less);
+    auto last = std::upper_bound(first, s.end(), to, [](const QDate &d, const RollupBucket &b) { return d < b.start; });
+    return {int(first - s.begin()), int(last - s.begin())};
+}
+
+QVector<RollupBucket> TrendRollups::range(RollupPeriod period, const QDate &from, const QDate &to) const
+{
+    auto [first, last] = bounds(period, periodStart(period, from), to);
+    return m_series[int(period)].mid(first, last - first);
+}
+
+RollupPeriod TrendRollups::periodFor(const QDate &from, const QDate &to, int maxBuckets) const
+{
+    for (int p = 0; p < PeriodCount - 1; ++p) {
+        auto [first, last] = bounds(RollupPeriod(p), periodStart(RollupPeriod(p), from), to);
+        if (last - first <= maxBuckets) return RollupPeriod(p);
+    }
+    return RollupPeriod::Month;
+}
+
+void TrendRollups::write(QDataStream &out) const
+{
+    out << quint32(PeriodCount) << quint32(CharIndex::TrackedCount);
+    for (const QVector<RollupBucket> &series : m_series) {
+        out << qint64(series.size());
+        for (const RollupBucket &b : series) {
+            out << qint64(b.start.toJulianDay()) << b.sessions << b.attempts << b.correct << b.duration << b.wpmSum;
+            for (int id = 0; id < CharIndex::TrackedCount; ++id) out << b.charTotal[id] << b.charErr[id];
+        }
+    }
+}
+
+bool TrendRollups::read(QDataStream &in)
+{
+    clear();
+    quint32 periods = 0, chars = 0;
+    in >> periods >> chars;
+    if (periods != quint32(PeriodCount) || chars != quint32(CharIndex::TrackedCount)) return false;
+
+    for (QVector<RollupBucket> &series : m_series) {
+        qint64 count = 0;
+        in >> count;
+        if (count < 0 || in.status() != QDataStream::Ok) return false;
+        series.reserve(int(count));
+        for (qint64 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            RollupBucket b;
+            qint64 julian = 0;
+            in >> julian >> b.sessions >> b.attempts >> b.correct >> b.duration >> b.wpmSum;
+            for (int id = 0; id < CharIndex::TrackedCount; ++id) in >> b.charTotal[id] >> b.charErr[id];
+            b.start = QDate::fromJulianDay(julian);
+            series.append(b);
+        }
+    }
+    if (in.status() != QDataStream::Ok) {
+        clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef TRENDROLLUPS_H
+#define TRENDROLLUPS_H
+
+// Include standard Qt classes for dates and containers
+#include <QDate>
+#include <QVector>
+#include <QDataStream>
+#include <array>
+#include <utility>
+#include "CharIndex.h"
+
+struct SessionRecord;
+
+// Length of one rollup bucket
+enum class RollupPeriod : quint8 {
+    Day = 0,
+    Week,  // Monday to Sunday
+    Month
+};
+
+// Aggregates of all sessions that started inside one period
+struct RollupBucket {
+    QDate start;            // First day of the period
+    qint32 sessions = 0;
+    qint64 attempts = 0;
+    qint64 correct = 0;
+    qint64 duration = 0;    // Seconds
+    qint64 wpmSum = 0;      // Sum of session WPM
+    std::array<qint32, CharIndex::TrackedCount> charTotal{}; // Times given, per tracked char
+    std::array<qint32, CharIndex::TrackedCount> charErr{};   // Times missed, per tracked char
+
+    double accuracy() const { return attempts > 0 ? correct * 100.0 / attempts : 0; }
+    double averageWpm() const { return sessions > 0 ? double(wpmSum) / sessions : 0; }
+};
+
+// Daily, weekly and monthly rollups of the session history.
+// Each session is folded into one bucket per period as it is ingested, so a
+// long-range trend is drawn from a few hundred buckets instead of every
+// session. Buckets are kept sorted by start date; range queries are binary
+// searches.
+class TrendRollups
+{
+public:
+    static constexpr int PeriodCount = 3;
+
+    // Folds one session into its day, week and month buckets
+    void add(const SessionRecord &record);
+    void clear();
+
+    // All buckets of a period, oldest first
+    const QVector<RollupBucket> &series(RollupPeriod period) const;
+    // Buckets of a period whose start lies in [from, to]
+    QVector<RollupBucket> range(RollupPeriod period, const QDate &from, const QDate &to) const;
+    // Finest period that covers [from, to] with at most maxBuckets buckets
+    RollupPeriod periodFor(const QDate &from, const QDate &to, int maxBuckets) const;
+
+    // First day of the period containing date
+    static QDate periodStart(RollupPeriod period, const QDate &date);
+
+    // Serialization (used by the statistics index file)
+    void write(QDataStream &out) const;
+    bool read(QDataStream &in);
+
+private:
+    // Index range [first, last) of the buckets starting in [from, to]
+    std::pair<int, int> bounds(RollupPeriod period, const QDate &from, const QDate &to) const;
+
+    std::array<QVector<RollupBucket>, PeriodCount> m_series;
+};
+
+#endif // TRENDROLLUPS_H
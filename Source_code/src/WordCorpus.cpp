@@ -0,0 +1,211 @@
+#include "WordCorpus.h"
+#include "CharIndex.h"
+#include <QDir>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Most recent candidate lists kept; each holds up to one int per entry
+const int kMaxCachedSets = 16;
+
+inline char upper(char c) { return (c >= 'a' && c <= 'z') ? char(c - 'a' + 'A') : c; }
+
+// Case-insensitive compare of two entries of the same length
+int compareText(const char *a, const char *b, int length)
+{
+    for (int i = 0; i < length; ++i) {
+        char x = upper(a[i]), y = upper(b[i]);
+        if (x != y) return x < y ? -1 : 1;
+    }
+    return 0;
+}
+
+// Mask of an ASCII line; false if a character has no Morse code
+bool lineMask(const char *p, int length, quint64 &mask)
+{
+    mask = 0;
+    for (int i = 0; i < length; ++i) {
+        if (p[i] == ' ') continue;
+        int id = CharIndex::id(QChar(uchar(p[i])));
+        if (id >= CharIndex::Count) return false;
+        mask |= quint64(1) << id;
+    }
+    return true;
+}
+}
+
+quint64 WordCorpus::maskFor(const QString &text, bool *ok)
+{
+    quint64 mask = 0;
+    bool valid = true;
+    for (QChar c : text) {
+        if (c == ' ') continue;
+        int id = CharIndex::id(c);
+        if (id >= CharIndex::Count) valid = false;
+        else mask |= quint64(1) << id;
+    }
+    if (ok) *ok = valid;
+    return mask;
+}
+
+bool WordCorpus::addFile(const QString &path)
+{
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly)) return false;
+    qint64 size = file->size();
+    if (size <= 0) return true;
+
+    // Entries point into the mapping, so it lives as long as the corpus
+    const char *data = reinterpret_cast<const char *>(file->map(0, size));
+    if (data) {
+        addBuffer(data, size);
+        m_files.push_back(std::move(file));
+    } else {
+        m_blobs.append(file->readAll());
+        addBuffer(m_blobs.last().constData(), m_blobs.last().size());
+    }
+    return true;
+}
+
+int WordCorpus::loadDirectory(const QString &dir)
+{
+    QDir d(dir);
+    int files = 0;
+    const QStringList names = d.entryList({"*.txt"}, QDir::Files, QDir::Name);
+    for (const QString &name : names) {
+        if (addFile(d.filePath(name))) files++;
+    }
+    return files;
+}
+
+void WordCorpus::addWords(const QStringList &words)
+{
+    m_blobs.append(words.join('\n').toLatin1());
+    addBuffer(m_blobs.last().constData(), m_blobs.last().size());
+}
+
+void WordCorpus::clear()
+{
+    m_entries.clear();
+    m_groups.clear();
+    m_cache.clear();
+    for (auto &file : m_files) file->close(); // Also unmaps
+    m_files.clear();
+    m_blobs.clear();
+    m_indexed = true;
+}
+
+void WordCorpus::addBuffer(const char *data, qint64 size)
+{
+    const char *p = data;
+    const char *end = data + size;
+    while (p < end) {
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+        // Trim surrounding whitespace (and the '\r' of Windows line ends)
+        const char *b = p;
+        const char *e = eol;
+        while (b < e && (*b == ' ' || *b == '\t')) ++b;
+        while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) --e;
+        int length = int(e - b);
+
+        quint64 mask;
+        if (length > 0 && length <= MaxLength && *b != '#' && lineMask(b, length, mask)) {
+            m_entries.append({mask, b, length});
+        }
+        p = eol + 1;
+    }
+    m_indexed = false;
+    m_cache.clear();
+}
+
+void WordCorpus::ensureIndex()
+{
+    if (m_indexed) return;
+
+    // Order by (mask, length, text), then drop duplicates between lists
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry &a, const Entry &b) {
+        if (a.mask != b.mask) return a.mask < b.mask;
+        if (a.length != b.length) return a.length < b.length;
+        return compareText(a.text, b.text, a.length) < 0;
+    });
+    auto last = std::unique(m_entries.begin(), m_entries.end(), [](const Entry &a, const Entry &b) {
+        return a.mask == b.mask && a.length == b.length && compareText(a.text, b.text, a.length) == 0;
+    });
+    m_entries.erase(last, m_entries.end());
+    m_entries.squeeze();
+
+    m_groups.clear();
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (m_groups.isEmpty() || m_groups.last().mask != m_entries[i].mask) m_groups.append({m_entries[i].mask, i, i});
+        m_groups.last().end = i + 1;
+    }
+    m_indexed = true;
+}
+
+int WordCorpus::lowerBound(const Group &group, int length, const char *text) const
+{
+    auto it = std::lower_bound(m_entries.cbegin() + group.begin, m_entries.cbegin() + group.end, length,
+                               [text](const Entry &e, int len) {
+        if (e.length != len) return e.length < len;
+        return text && compareText(e.text, text, len) < 0;
+    });
+    return int(it - m_entries.cbegin());
+}
+
+QString WordCorpus::word(int i) const
+{
+    const Entry &e = m_entries[i];
+    return QString::fromLatin1(e.text, e.length).toUpper();
+}
+
+bool WordCorpus::contains(const QString &text)
+{
+    bool ok;
+    quint64 mask = maskFor(text, &ok);
+    QByteArray latin = text.toLatin1();
+    if (!ok || latin.isEmpty() || latin.size() > MaxLength) return false;
+    ensureIndex();
+
+    auto group = std::lower_bound(m_groups.cbegin(), m_groups.cend(), mask, [](const Group &g, quint64 m) {
+        return g.mask < m;
+    });
+    if (group == m_groups.cend() || group->mask != mask) return false;
+    int i = lowerBound(*group, latin.size(), latin.constData());
+    return i < group->end && m_entries[i].length == latin.size()
+        && compareText(m_entries[i].text, latin.constData(), latin.size()) == 0;
+}
+
+const QVector<int> &WordCorpus::candidates(quint64 allowed, int minLength, int maxLength)
+{
+    ensureIndex();
+    minLength = qBound(1, minLength, MaxLength);
+    maxLength = qBound(minLength, maxLength, MaxLength);
+    const QPair<quint64, int> key(allowed, (minLength << 8) | maxLength);
+    auto cached = m_cache.constFind(key);
+    if (cached != m_cache.cend()) return *cached;
+
+    // One pass over the distinct masks; within a group the length range is contiguous
+    QVector<int> ids;
+    for (const Group &group : m_groups) {
+        if (group.mask & ~allowed) continue;
+        int from = lowerBound(group, minLength, nullptr);
+        int to = lowerBound(group, maxLength + 1, nullptr);
+        for (int i = from; i < to; ++i) ids.append(i);
+    }
+
+    if (m_cache.size() >= kMaxCachedSets) m_cache.clear();
+    return *m_cache.insert(key, ids);
+}
+
+int WordCorpus::candidateCount(quint64 allowed, int minLength, int maxLength)
+{
+    return candidates(allowed, minLength, maxLength).size();
+}
+
+QString WordCorpus::draw(quint64 allowed, int minLength, int maxLength, QRandomGenerator *rng)
+{
+    const QVector<int> &ids = candidates(allowed, minLength, maxLength);
+    if (ids.isEmpty()) return QString();
+    return word(ids[int(rng->bounded(quint32(ids.size())))]);
+}
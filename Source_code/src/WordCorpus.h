@@ -0,0 +1,85 @@
+#ifndef WORDCORPUS_H
+#define WORDCORPUS_H
+
+// Include standard Qt classes for strings, containers and random numbers
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QFile>
+#include <QRandomGenerator>
+#include <memory>
+#include <vector>
+
+// Word lists for the words drill (words, callsigns, QSO phrases).
+// Files are memory-mapped and every line is kept as a pointer into the
+// mapping, tagged with the set of characters it uses as a 64-bit mask of
+// CharIndex ids. Entries are sorted by (mask, length), so the words that only
+// use an allowed character set are the union of the groups whose mask is a
+// subset of it. That candidate list is built once per allowed set and length
+// range and cached, after which every draw is a single uniform index.
+class WordCorpus
+{
+public:
+    static constexpr int MaxLength = 64; // Longer lines are skipped
+
+    // Character set mask of a text (space is always allowed and not counted).
+    // ok is false if the text contains a character without a Morse code.
+    static quint64 maskFor(const QString &text, bool *ok = nullptr);
+
+    // Adds every line of a text file (one entry per line, '#' starts a comment line)
+    bool addFile(const QString &path);
+    // Adds every *.txt file of a directory; returns the number of files read
+    int loadDirectory(const QString &dir = defaultDirectory());
+    // Adds in-memory words (e.g. the built-in list)
+    void addWords(const QStringList &words);
+    void clear();
+
+    int size() const { return m_entries.size(); }
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    QString word(int i) const;
+    // Whether text is in the corpus (case-insensitive), O(log n)
+    bool contains(const QString &text);
+
+    // Number of entries within the allowed set and length range
+    int candidateCount(quint64 allowed, int minLength = 1, int maxLength = MaxLength);
+    // Random entry within the allowed set and length range (empty if none)
+    QString draw(quint64 allowed, int minLength = 1, int maxLength = MaxLength,
+                 QRandomGenerator *rng = QRandomGenerator::global());
+
+    // Word lists are looked up next to the statistics
+    static QString defaultDirectory() { return QStringLiteral("words"); }
+
+private:
+    struct Entry {
+        quint64 mask;
+        const char *text; // Inside a mapping or blob, not null-terminated
+        int length;
+    };
+    // Entries [begin, end) share one mask and are sorted by length, then text
+    struct Group {
+        quint64 mask;
+        int begin;
+        int end;
+    };
+
+    void addBuffer(const char *data, qint64 size);
+    void ensureIndex();
+    const QVector<int> &candidates(quint64 allowed, int minLength, int maxLength);
+    // First entry of a group not ordered before (length, text)
+    int lowerBound(const Group &group, int length, const char *text) const;
+
+    std::vector<std::unique_ptr<QFile>> m_files; // Kept open while mapped
+    QList<QByteArray> m_blobs;                   // Unmappable files and in-memory words
+    QVector<Entry> m_entries;
+    QVector<Group> m_groups;                     // Sorted by mask
+    bool m_indexed = true;
+
+    // Candidate entry ids per (allowed mask, length range)
+    QHash<QPair<quint64, int>, QVector<int>> m_cache;
+};
+
+#endif // WORDCORPUS_H
@@ -0,0 +1,369 @@
+#include "MorseSynth.h"
+#include "StatisticsTracker.h"
+#include "EditAligner.h"
+#include "SerialManager.h"
+#include "SessionStore.h"
+#include "StatsIndex.h"
+#include "LegacyCsvLoader.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+
+// Benchmarks of the hot paths: Morse synthesis, attempt scoring, serial
+// parsing and statistics loading. Each case runs until it has taken at least
+// --min-time, then reports the median of five such batches. Results go to
+// stdout (or --output) as JSON so runs can be compared over time; a readable
+// line per case goes to stderr.
+
+namespace {
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// Keeps results alive so the measured work cannot be optimized away
+volatile qint64 g_sink = 0;
+void keep(qint64 value) { g_sink = g_sink + value; }
+
+class Bench
+{
+public:
+    Bench(qint64 minTimeMs, const QString &filter) : m_minTimeNs(minTimeMs * 1000000), m_filter(filter) {}
+
+    // Times op(); bytesPerOp > 0 adds a throughput figure
+    template <typename Op>
+    void run(const QString &name, const QJsonObject &params, Op op, qint64 bytesPerOp = 0)
+    {
+        if (!m_filter.isEmpty() && !name.contains(m_filter)) return;
+
+        // Warm up, then grow the batch until it takes minTime
+        op();
+        qint64 iterations = 1;
+        for (;;) {
+            qint64 ns = timeBatch(op, iterations);
+            if (ns >= m_minTimeNs || iterations >= (qint64(1) << 40)) break;
+            // Aim a little past minTime, at most 10x per step
+            double scale = ns > 0 ? 1.2 * double(m_minTimeNs) / ns : 10.0;
+            iterations = qMax(iterations + 1, qint64(iterations * qMin(scale, 10.0)));
+        }
+
+        QVector<double> perOp;
+        for (int i = 0; i < 5; ++i) perOp.append(double(timeBatch(op, iterations)) / iterations);
+        std::sort(perOp.begin(), perOp.end());
+
+        QJsonObject result;
+        result["name"] = name;
+        result["params"] = params;
+        result["iterations"] = iterations;
+        result["ns_per_op"] = perOp[2];
+        result["ns_per_op_min"] = perOp[0];
+        result["ns_per_op_max"] = perOp[4];
+        if (bytesPerOp > 0) {
+            result["bytes_per_op"] = bytesPerOp;
+            result["mb_per_s"] = bytesPerOp / perOp[2] * 1e9 / (1024.0 * 1024.0);
+        }
+        m_results.append(result);
+
+        QStringList args;
+        for (auto it = params.begin(); it != params.end(); ++it) {
+            args << it.key() + "=" + it.value().toVariant().toString();
+        }
+        err() << name << ' ' << args.join(' ') << ": " << QString::number(perOp[2], 'f', 0) << " ns/op";
+        if (bytesPerOp > 0) err() << ", " << QString::number(result["mb_per_s"].toDouble(), 'f', 1) << " MB/s";
+        err() << Qt::endl;
+    }
+
+    const QJsonArray &results() const { return m_results; }
+
+private:
+    template <typename Op>
+    static qint64 timeBatch(Op &op, qint64 iterations)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for (qint64 i = 0; i < iterations; ++i) op();
+        return timer.nsecsElapsed();
+    }
+
+    qint64 m_minTimeNs;
+    QString m_filter;
+    QJsonArray m_results;
+};
+
+// Random text over the Morse alphabet with roughly one space per five characters
+QString randomText(int length, QRandomGenerator &rng)
+{
+    static const QString chars = QStringLiteral("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789?/.,");
+    QString text;
+    text.reserve(length);
+    for (int i = 0; i < length; ++i) {
+        text += (i % 6 == 5) ? QChar(' ') : chars[rng.bounded(chars.size())];
+    }
+    return text;
+}
+
+// A copy of target with about one error in ten characters
+QString withErrors(const QString &target, QRandomGenerator &rng)
+{
+    QString typed;
+    for (QChar c : target) {
+        int roll = rng.bounded(30);
+        if (roll == 0) continue;                    // Omission
+        if (roll == 1) { typed += 'E'; continue; }  // Substitution
+        typed += c;
+        if (roll == 2) typed += 'T';                // Insertion
+    }
+    return typed;
+}
+
+void benchSynthesis(Bench &bench)
+{
+    QRandomGenerator rng(1);
+    for (int length : {10, 100, 1000}) {
+        const QString text = randomText(length, rng);
+        for (int wpm : {15, 25, 40}) {
+            bench.run("generateAudioData", {{"chars", length}, {"wpm", wpm}}, [&]() {
+                keep(MorseSynth::generateAudioData(text, wpm, 600, 0).size());
+            });
+        }
+    }
+    for (double seconds : {0.06, 0.5, 2.0}) {
+        const qint64 bytes = qint64(MorseSynth::SampleRate * seconds) * 2;
+        bench.run("createTone", {{"seconds", seconds}}, [&]() {
+            keep(MorseSynth::createTone(seconds, 600, MorseSynth::SampleRate).size());
+        }, bytes);
+    }
+}
+
+// Scoring must keep what was copied on the ties a plain edit distance leaves
+// open; a benchmark of a wrong scorer is worth nothing, so this runs first
+bool checkScoring()
+{
+    struct Case { const char *target; const char *typed; int distance; int matches; };
+    static const Case cases[] = {
+        {"AB", "BA", 2, 1},        // Transposition keeps one character
+        {"PARIS", "PAIRS", 2, 4},  // Transposition inside a word
+        {"PARIS", "PARS", 1, 4},   // Omission
+        {"PARIS", "PARIIS", 1, 5}, // Insertion
+        {"HI", "SI", 1, 1},        // Substitution stays a substitution
+        {"CQ", "CQ", 0, 2},
+        {"CQ", "", 2, 0},
+    };
+    bool ok = true;
+    for (const Case &c : cases) {
+        Alignment a = EditAligner::align(c.target, c.typed);
+        if (a.distance != c.distance || a.matches != c.matches) {
+            err() << "Scoring check failed: " << c.target << " typed " << c.typed << ": distance "
+                  << a.distance << ", " << a.matches << " matches (expected " << c.distance
+                  << ", " << c.matches << ")" << Qt::endl;
+            ok = false;
+        }
+    }
+    // The counts that go into the character statistics follow the same alignment
+    StatisticsTracker tracker;
+    if (tracker.recordAttempt("AB", "BA").first != 1) {
+        err() << "Scoring check failed: recordAttempt(AB, BA) does not count the copied character" << Qt::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+void benchScoring(Bench &bench)
+{
+    QRandomGenerator rng(2);
+    for (int length : {5, 25, 100, 500}) {
+        // A ring of attempts so the same strings are not scored over and over
+        QVector<QPair<QString, QString>> attempts;
+        for (int i = 0; i < 64; ++i) {
+            QString target = randomText(length, rng);
+            attempts.append({target, withErrors(target, rng)});
+        }
+        StatisticsTracker tracker;
+        int next = 0;
+        bench.run("recordAttempt", {{"chars", length}}, [&]() {
+            const auto &attempt = attempts[next++ & 63];
+            keep(tracker.recordAttempt(attempt.first, attempt.second).first);
+        });
+    }
+}
+
+// Device output: decoded characters wrapped in tone tokens, words, newlines
+// and now and then a status line
+QByteArray deviceStream(qint64 bytes, QRandomGenerator &rng)
+{
+    static const char *status[] = {"WPM set to 22", "Tone set to 650", "Mode set to Iambic B",
+                                   "Action: Buffer Cleared", "Encoded: CQ TEST", "[Done]"};
+    QByteArray data;
+    data.reserve(bytes + 64);
+    int column = 0;
+    while (data.size() < bytes) {
+        int roll = rng.bounded(100);
+        if (roll < 2) {
+            data += "\r\n";
+            data += status[rng.bounded(6)];
+            data += "\r\n";
+            column = 0;
+        } else if (roll < 15 || column > 60) {
+            data += (column > 60) ? "\r\n" : " ";
+            if (column > 60) column = 0;
+        } else {
+            data += "[]";
+            data += char('A' + rng.bounded(26));
+            column++;
+        }
+    }
+    return data;
+}
+
+void benchSerial(Bench &bench)
+{
+    QRandomGenerator rng(3);
+    const QByteArray stream = deviceStream(64 * 1024, rng);
+    SerialManager serial;
+    qint64 events = 0;
+    QObject::connect(&serial, &SerialManager::textReceived, [&events](const QString &t) { events += t.size(); });
+    QObject::connect(&serial, &SerialManager::systemLineReceived, [&events]() { events++; });
+    QObject::connect(&serial, &SerialManager::toneStartReceived, [&events]() { events++; });
+
+    for (int chunk : {1, 16, 512}) {
+        // Split once up front; only the parsing is timed
+        QVector<QByteArray> chunks;
+        for (qint64 pos = 0; pos < stream.size(); pos += chunk) chunks.append(stream.mid(pos, chunk));
+        bench.run("SerialManager::processData", {{"chunk_bytes", chunk}, {"stream_bytes", qint64(stream.size())}}, [&]() {
+            for (const QByteArray &c : chunks) serial.processData(c);
+        }, stream.size());
+    }
+    keep(events);
+}
+
+// Sessions over the given number of years: three a day at varying speed
+QVector<SessionRecord> sessionHistory(int years, QRandomGenerator &rng)
+{
+    QVector<SessionRecord> records;
+    QDateTime start = QDateTime::currentDateTime().addYears(-years);
+    const QDateTime end = QDateTime::currentDateTime();
+    while (start < end) {
+        SessionRecord r;
+        r.start = start;
+        r.duration = 300 + rng.bounded(1500);
+        r.attempts = 20 + rng.bounded(100);
+        r.correct = rng.bounded(r.attempts + 1);
+        r.wrong = r.attempts - r.correct;
+        r.accuracy = r.correct * 100.0f / r.attempts;
+        r.wpm = 15 + rng.bounded(20);
+        r.tone = 600;
+        r.mode = "OFFLINE";
+        r.items = "CQ(G:2/OK:1/ERR:1);PARIS(G:3/OK:3/ERR:0);";
+        for (int id = 0; id < CharIndex::TrackedCount; ++id) {
+            CharCounts &c = r.chars[id];
+            c.total = rng.bounded(20);
+            c.err = rng.bounded(c.total + 1);
+            c.ok = c.total - c.err;
+        }
+        records.append(r);
+        start = start.addSecs(8 * 3600);
+    }
+    return records;
+}
+
+void benchStats(Bench &bench)
+{
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        err() << "No temporary directory, statistics benchmarks skipped" << Qt::endl;
+        return;
+    }
+    QRandomGenerator rng(4);
+    for (int years : {1, 5, 10}) {
+        const QString storePath = dir.filePath(QString("stats_%1.cws").arg(years));
+        const QString csvPath = dir.filePath(QString("stats_%1.csv").arg(years));
+        const QVector<SessionRecord> records = sessionHistory(years, rng);
+        if (!SessionStore::writeStore(storePath, records) || !SessionStore(storePath).exportCsv(csvPath)) {
+            err() << "Could not write the test history, statistics benchmarks skipped" << Qt::endl;
+            return;
+        }
+        const qint64 csvBytes = QFileInfo(csvPath).size();
+        const QJsonObject params{{"years", years}, {"rows", qint64(records.size())}};
+
+        // Legacy import path: all threads, then one thread for comparison
+        bench.run("LegacyCsvLoader::load", params, [&]() {
+            keep(LegacyCsvLoader::load(csvPath).records.size());
+        }, csvBytes);
+        QJsonObject single = params;
+        single["threads"] = 1;
+        bench.run("LegacyCsvLoader::load", single, [&]() {
+            keep(LegacyCsvLoader::load(csvPath, 1).records.size());
+        }, csvBytes);
+
+        // What the statistics window does on first open: map the store and
+        // fold every row into an empty index
+        const QString indexPath = dir.filePath("unused.idx");
+        bench.run("StatsIndex::sync", params, [&]() {
+            SessionStore store(storePath);
+            StatsIndex index(indexPath);
+            if (store.open() && index.sync(store)) keep(index.sessions().size());
+        });
+    }
+}
+
+} // namespace
+
+// Benchmark Entry Point
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cw_trainer_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks of the CW Trainer hot paths (JSON on stdout).");
+    parser.addHelpOption();
+    parser.addOptions({
+        {{"o", "output"}, "Write the JSON report to a file instead of stdout.", "file"},
+        {"filter", "Only run cases whose name contains this text.", "text"},
+        {"min-time", "Minimum time per measured batch.", "ms", "200"},
+    });
+    parser.process(app);
+
+    if (!checkScoring()) return 1;
+
+    Bench bench(qMax(1, parser.value("min-time").toInt()), parser.value("filter"));
+    benchSynthesis(bench);
+    benchScoring(bench);
+    benchSerial(bench);
+    benchStats(bench);
+
+    QJsonObject report;
+    report["suite"] = "cw_trainer_bench";
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["qt_version"] = QString(qVersion());
+#ifdef QT_DEBUG
+    report["build"] = "debug";
+#else
+    report["build"] = "release";
+#endif
+    report["results"] = bench.results();
+    const QByteArray json = QJsonDocument(report).toJson();
+
+    const QString output = parser.value("output");
+    if (output.isEmpty()) {
+        QTextStream(stdout) << json;
+        return 0;
+    }
+    QFile file(output);
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size()) {
+        err() << "Cannot write " << output << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
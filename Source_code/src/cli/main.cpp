@@ -0,0 +1,295 @@
+#include "TrainerEngine.h"
+#include "MorseSynth.h"
+#include "SessionStore.h"
+#include "StatsIndex.h"
+#include "CharIndex.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QFile>
+#include <QDir>
+#include <QDataStream>
+#include <algorithm>
+
+// Command-line front end of the trainer engine, for scripted drills and
+// headless machines. Works on the statistics files in the current directory,
+// like the GUI.
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// Writes 16-bit mono PCM as a WAV file
+bool writeWav(const QString &path, const QByteArray &pcm, int sampleRate)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    const quint32 dataSize = quint32(pcm.size());
+    stream.writeRawData("RIFF", 4);
+    stream << quint32(36 + dataSize);
+    stream.writeRawData("WAVEfmt ", 8);
+    stream << quint32(16) << quint16(1) << quint16(1)      // PCM, mono
+           << quint32(sampleRate) << quint32(sampleRate * 2) // Byte rate
+           << quint16(2) << quint16(16);                     // Block align, bits
+    stream.writeRawData("data", 4);
+    stream << dataSize;
+    stream.writeRawData(pcm.constData(), pcm.size());
+    return stream.status() == QDataStream::Ok;
+}
+
+// Drill settings from the command line; false (with a message) on a bad value
+bool parseSettings(const QCommandLineParser &parser, DrillSettings &settings)
+{
+    const QString mode = parser.value("mode");
+    if (mode == "random") settings.mode = DrillMode::Random;
+    else if (mode == "words") settings.mode = DrillMode::Words;
+    else if (mode == "koch") settings.mode = DrillMode::Koch;
+    else if (mode == "qso") settings.mode = DrillMode::Qso;
+    else if (mode == "text") settings.mode = DrillMode::Text;
+    else {
+        err() << "Unknown mode: " << mode << Qt::endl;
+        return false;
+    }
+
+    const QString kind = parser.value("qso-kind");
+    if (kind == "callsign") settings.qsoKind = QsoKind::Callsign;
+    else if (kind == "serial") settings.qsoKind = QsoKind::SerialExchange;
+    else if (kind == "zone") settings.qsoKind = QsoKind::ZoneExchange;
+    else if (kind == "ragchew") settings.qsoKind = QsoKind::Ragchew;
+    else {
+        err() << "Unknown QSO kind: " << kind << Qt::endl;
+        return false;
+    }
+
+    const QString level = parser.value("text-level");
+    if (level == "letter") settings.textLevel = MarkovTextGenerator::Level::Character;
+    else if (level == "word") settings.textLevel = MarkovTextGenerator::Level::Word;
+    else {
+        err() << "Unknown text level: " << level << Qt::endl;
+        return false;
+    }
+
+    settings.groupSize = qBound(1, parser.value("group").toInt(), 50);
+    settings.allowedChars = parser.value("chars");
+    settings.adaptive = parser.isSet("adaptive");
+    settings.review = parser.isSet("review");
+    settings.ignoreSpacing = parser.isSet("ignore-spacing");
+    return true;
+}
+
+// drill: prints each target (or renders it to audioDir), reads the answer
+// from stdin and scores it
+int runDrill(TrainerEngine &engine, const DrillSettings &settings, const QCommandLineParser &parser)
+{
+    const int count = qMax(1, parser.value("count").toInt());
+    const int wpm = qMax(1, parser.value("wpm").toInt());
+    const int tone = parser.value("tone").toInt();
+    const int spacing = parser.value("spacing").toInt();
+    const QString audioDir = parser.value("audio-dir");
+    if (!audioDir.isEmpty() && !QDir().mkpath(audioDir)) {
+        err() << "Cannot create " << audioDir << Qt::endl;
+        return 1;
+    }
+
+    QTextStream in(stdin);
+    int correct = 0;
+    int done = 0;
+    for (; done < count; ++done) {
+        const QString target = engine.generateTarget(settings);
+        if (audioDir.isEmpty()) {
+            out() << target << Qt::endl;
+        } else {
+            // Copy practice: only the audio file is named, not the text
+            QString path = QDir(audioDir).filePath(QString("%1.wav").arg(done + 1, 3, 10, QChar('0')));
+            if (!writeWav(path, MorseSynth::generateAudioData(target, wpm, tone, spacing), MorseSynth::SampleRate)) {
+                err() << "Cannot write " << path << Qt::endl;
+                return 1;
+            }
+            out() << path << Qt::endl;
+        }
+
+        QString answer;
+        if (!in.readLineInto(&answer)) break;
+        AttemptResult result = engine.scoreAttempt(settings, target, answer);
+        if (result.correct) correct++;
+        out() << (result.correct ? "OK" : "WRONG") << '\t' << target << '\t'
+              << result.matched << '/' << result.total;
+        if (result.unlocked) out() << "\tNEW " << engine.koch().newestChar();
+        out() << Qt::endl;
+    }
+    out() << "SUMMARY\t" << correct << '/' << done << Qt::endl;
+    return 0;
+}
+
+// score: one "target<TAB>answer" per line
+int runScore(TrainerEngine &engine, const DrillSettings &settings, const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        err() << "Cannot open " << path << Qt::endl;
+        return 1;
+    }
+    QTextStream in(&file);
+    QString line;
+    int lineNo = 0;
+    int correct = 0;
+    int scored = 0;
+    int matched = 0;
+    int total = 0;
+    while (in.readLineInto(&line)) {
+        lineNo++;
+        if (line.trimmed().isEmpty() || line.startsWith('#')) continue;
+        const int tab = line.indexOf('\t');
+        if (tab < 0) {
+            err() << path << ':' << lineNo << ": no tab, skipped" << Qt::endl;
+            continue;
+        }
+        const QString target = line.left(tab);
+        const QString answer = line.mid(tab + 1);
+        AttemptResult result = engine.scoreAttempt(settings, target, answer);
+        scored++;
+        if (result.correct) correct++;
+        matched += result.matched;
+        total += result.total;
+        out() << lineNo << '\t' << (result.correct ? "OK" : "WRONG") << '\t'
+              << result.matched << '/' << result.total << Qt::endl;
+    }
+    out() << "SUMMARY\t" << correct << '/' << scored << " items\t"
+          << matched << '/' << total << " characters copied" << Qt::endl;
+    return 0;
+}
+
+// stats: session history and all-time per-character error rates.
+// The refreshed index is only written back with save.
+int runStats(bool save)
+{
+    SessionStore store;
+    StatsIndex index;
+    index.load();
+    store.open();
+    if (index.sync(store) && save) index.save();
+
+    const QList<SessionData> &sessions = index.sessions();
+    qint64 seconds = 0;
+    for (const SessionData &s : sessions) seconds += s.duration;
+    out() << "SESSIONS\t" << sessions.size() << Qt::endl;
+    out() << "TIME\t" << seconds / 3600 << 'h' << (seconds / 60) % 60 << 'm' << Qt::endl;
+    if (!sessions.isEmpty()) {
+        const SessionData &last = sessions.last();
+        out() << "LAST\t" << last.dateTime.toString(Qt::ISODate) << '\t'
+              << last.wpm << " WPM\t" << QString::number(last.accuracy, 'f', 1) << '%' << Qt::endl;
+    }
+
+    // Characters by error rate, worst first
+    const auto &totals = index.charTotals();
+    QVector<int> ids;
+    for (int id = 0; id < CharIndex::TrackedCount; ++id) {
+        if (totals[id].total > 0) ids.append(id);
+    }
+    auto rate = [&totals](int id) { return double(totals[id].err) / totals[id].total; };
+    std::stable_sort(ids.begin(), ids.end(), [&rate](int a, int b) { return rate(a) > rate(b); });
+    for (int id : ids) {
+        out() << "CHAR\t" << CharIndex::label(id) << '\t' << totals[id].total << '\t'
+              << totals[id].err << '\t' << QString::number(rate(id) * 100, 'f', 1) << '%' << Qt::endl;
+    }
+    return 0;
+}
+
+// render: text to a WAV file
+int runRender(const QString &text, const QCommandLineParser &parser)
+{
+    const QString path = parser.value("output");
+    const QByteArray pcm = MorseSynth::generateAudioData(text, qMax(1, parser.value("wpm").toInt()),
+                                                             parser.value("tone").toInt(),
+                                                             parser.value("spacing").toInt());
+    if (!writeWav(path, pcm, MorseSynth::SampleRate)) {
+        err() << "Cannot write " << path << Qt::endl;
+        return 1;
+    }
+    out() << path << '\t' << pcm.size() / 2 * 1000 / MorseSynth::SampleRate << " ms" << Qt::endl;
+    return 0;
+}
+
+} // namespace
+
+// Command-line Entry Point
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("cw_trainer_cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("CW Trainer without a window.\n"
+        "  drill           print targets, read answers from stdin, score them\n"
+        "  score <file>    score \"target<TAB>answer\" lines\n"
+        "  stats           session history and per-character error rates\n"
+        "  render <text>   write the Morse audio of text to a WAV file");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "drill, score, stats or render");
+    parser.addOptions({
+        {"mode", "Drill mode: random, words, koch, qso or text.", "mode", "random"},
+        {"group", "Group size (words for text mode).", "n", "5"},
+        {"chars", "Allowed characters (random, words and text modes).", "chars"},
+        {"count", "Number of drill items.", "n", "10"},
+        {"adaptive", "Weight characters by error rate and latency."},
+        {"review", "Mix in due spaced-repetition reviews."},
+        {"ignore-spacing", "Spaces do not count when checking."},
+        {"qso-kind", "callsign, serial, zone or ragchew.", "kind", "callsign"},
+        {"text-level", "letter or word.", "level", "letter"},
+        {"save", "Save the session and the Koch lesson; stats: the statistics index (otherwise nothing is written)."},
+        {"audio-dir", "drill: write each target as a WAV file instead of printing it.", "dir"},
+        {{"o", "output"}, "render: output file.", "file", "morse.wav"},
+        {"wpm", "Audio speed.", "wpm", "20"},
+        {"tone", "Audio tone.", "hz", "600"},
+        {"spacing", "Extra spacing between characters.", "ms", "0"},
+    });
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    const QString command = args.value(0);
+
+    if (command == "stats") return runStats(parser.isSet("save"));
+    if (command == "render") {
+        if (args.size() < 2) {
+            err() << "render needs the text to play" << Qt::endl;
+            return 1;
+        }
+        return runRender(args.mid(1).join(' '), parser);
+    }
+    if (command != "drill" && command != "score") parser.showHelp(1);
+
+    DrillSettings settings;
+    if (!parseSettings(parser, settings)) return 1;
+
+    // Only a session that is going to be saved is journaled or written back
+    const bool save = parser.isSet("save");
+    TrainerEngine engine;
+    engine.load(save);
+    engine.tracker()->setCurrentWpm(parser.value("wpm").toInt());
+
+    int result = 0;
+    if (command == "drill") {
+        result = runDrill(engine, settings, parser);
+    } else {
+        if (args.size() < 2) {
+            err() << "score needs an answer file" << Qt::endl;
+            return 1;
+        }
+        result = runScore(engine, settings, args.at(1));
+    }
+
+    if (save) engine.saveSession(parser.value("wpm").toInt(), parser.value("tone").toInt(), "CLI");
+    return result;
+}
@@ -1,11 +1,20 @@
 #include "MainWindow.h"
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QDebug>
 
 // Main Application Entry Point
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startup;
+    startup.start();
+    
     // Create the Qt Application instance
     QApplication a(argc, argv);
+    // Names for QSettings (last used port and audio device)
+    QApplication::setOrganizationName("CW_Trainer-GNR");
+    QApplication::setApplicationName("CW_Trainer-GNR");
+    qInfo().noquote() << QString("Startup: application after %1 ms").arg(startup.elapsed());
     
     // Create the Main Window of the application
     MainWindow w;